@@ -37,6 +37,7 @@
 #include <fstream>
 #include <string>
 #include <memory>
+#include <vector>
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
@@ -128,6 +129,55 @@ Prop2String property_2_strings[] = { // sorted by 'prop'
 };
 
 
+/*
+ * Collects the literal characters a (full match) regular expression starts
+ * with. Stops at the first special character, a literal that is followed
+ * by a quantifier that allows it to be skipped is not part of the prefix.
+ * Alternations anywhere in the expression disable the prefix.
+ */
+FbTk::FbString regexLiteralPrefix(const FbTk::FbString &regex) {
+
+    FbTk::FbString prefix;
+
+#ifdef USE_REGEXP
+    if (regex.find('|') != FbTk::FbString::npos)
+        return prefix;
+
+    static const char special[] = ".[]()*+?{}|^$\\";
+
+    size_t i = 0;
+    while (i < regex.size()) {
+        char c = regex[i];
+        size_t next = i + 1;
+        if (c == '\\') {
+            // only escaped punctuation is a plain literal
+            if (next >= regex.size() || !strchr(special, regex[next]))
+                break;
+            c = regex[next++];
+        } else if (strchr(special, c)) {
+            break;
+        }
+
+        if (next < regex.size()) {
+            char q = regex[next];
+            if (q == '*' || q == '?' || q == '{')
+                break;
+            if (q == '+') {
+                prefix += c;
+                break;
+            }
+        }
+        prefix += c;
+        i = next;
+    }
+#else // notdef USE_REGEXP
+    // without regular expressions terms are matched by plain equality
+    prefix = regex;
+#endif // USE_REGEXP
+
+    return prefix;
+}
+
 } // end of anonymous namespace
 
 
@@ -144,7 +194,9 @@ struct ClientPattern::Term {
         xpropstr(_xprop),
         regexp(_regstr, true),
         prop(_prop),
-        negate(_negate) {
+        negate(_negate),
+        current(_regstr == "[current]"),
+        mouse(_regstr == "[mouse]") {
 
         xprop = XInternAtom(FbTk::App::instance()->display(), xpropstr.c_str(), False);
     }
@@ -156,8 +208,84 @@ struct ClientPattern::Term {
     FbTk::RegExp regexp;       // compiled version of '.*bar'
     WinProperty prop;
     bool negate;
+    bool current;              // regstr is [current]
+    bool mouse;                // regstr is [mouse]
 };
 
+namespace {
+
+// the client whose X properties a focusable reports, if any
+const WinClient *propertyClient(const Focusable &win) {
+    const WinClient *client = dynamic_cast<const WinClient *>(&win);
+    if (client)
+        return client;
+
+    const FluxboxWindow *fbwin = win.fbwindow();
+    if (fbwin && static_cast<const Focusable *>(fbwin) == &win &&
+        fbwin->numClients() > 0)
+        return &fbwin->winClient();
+    return 0;
+}
+
+// workspace, head and screen numbers are small, keep their strings around
+const FbTk::FbString &numberString(int num, FbTk::FbString &scratch) {
+    static std::vector<FbTk::FbString> numbers;
+    if (numbers.empty()) {
+        for (int i = 0; i < 64; ++i)
+            numbers.push_back(FbTk::StringUtil::number2String(i));
+    }
+
+    if (num >= 0 && num < static_cast<int>(numbers.size()))
+        return numbers[num];
+
+    scratch = FbTk::StringUtil::number2String(num);
+    return scratch;
+}
+
+/*
+ * Same as ClientPattern::getProperty(), but avoids copies and X round
+ * trips where it can: strings the focusable holds anyway are returned by
+ * reference, X properties come from the cache of the client and only
+ * everything else is produced in scratch.
+ */
+const FbTk::FbString &matchValue(ClientPattern::WinProperty prop,
+                                 const Focusable &win,
+                                 FbTk::FbString &scratch) {
+
+    const FluxboxWindow *fbwin = win.fbwindow();
+
+    switch (prop) {
+    case ClientPattern::TITLE:
+        return win.title().logical();
+    case ClientPattern::CLASS:
+        return win.getWMClassClass();
+    case ClientPattern::NAME:
+        return win.getWMClassName();
+    case ClientPattern::ROLE: {
+        const WinClient *client = propertyClient(win);
+        if (client)
+            return client->cachedWMRole();
+        break;
+    }
+    case ClientPattern::WORKSPACE:
+        return numberString(fbwin ? fbwin->workspaceNumber() :
+                            win.screen().currentWorkspaceID(), scratch);
+    case ClientPattern::HEAD:
+        if (fbwin)
+            return numberString(win.screen().getHead(fbwin->fbWindow()), scratch);
+        break;
+    case ClientPattern::SCREEN:
+        return numberString(win.screen().screenNumber(), scratch);
+    default:
+        break;
+    }
+
+    scratch = ClientPattern::getProperty(prop, win);
+    return scratch;
+}
+
+} // end anonymous namespace
+
 ClientPattern::ClientPattern():
     m_matchlimit(0),
     m_nummatches(0) {}
@@ -310,29 +438,41 @@ bool ClientPattern::match(const Focusable &win) const {
     // regmatch everything
     // currently, we use an "AND" policy for multiple terms
     // changing to OR would require minor modifications in this function only
+    FbTk::FbString scratch, focused_scratch;
+
     Terms::const_iterator it = m_terms.begin();
     Terms::const_iterator it_end = m_terms.end();
     for (; it != it_end; ++it) {
         const Term& term = *(*it);
         if (term.prop == XPROP) {
-            if (!term.negate ^ ((term.regexp.match(win.getTextProperty(term.xprop))) || term.regexp.match(FbTk::StringUtil::number2String(win.getCardinalProperty(term.xprop)))))
+            const WinClient *client = propertyClient(win);
+            bool match;
+            if (client) {
+                match = term.regexp.match(client->cachedTextProperty(term.xprop)) ||
+                        term.regexp.match(client->cachedCardinalProperty(term.xprop));
+            } else {
+                match = term.regexp.match(win.getTextProperty(term.xprop)) ||
+                        term.regexp.match(FbTk::StringUtil::number2String(win.getCardinalProperty(term.xprop)));
+            }
+            if (!term.negate ^ match)
                 return false;
-        } else if (term.regstr == "[current]") {
+        } else if (term.current) {
             WinClient *focused = FocusControl::focusedWindow();
+            const FbTk::FbString &value = matchValue(term.prop, win, scratch);
             if (term.prop == WORKSPACE) {
-                if (!term.negate ^ (getProperty(term.prop, win) == FbTk::StringUtil::number2String(win.screen().currentWorkspaceID())))
+                if (!term.negate ^ (value == numberString(win.screen().currentWorkspaceID(), focused_scratch)))
                     return false;
             } else if (term.prop == WORKSPACENAME) {
                 const Workspace *w = win.screen().currentWorkspace();
-                if (!w || (!term.negate ^ (getProperty(term.prop, win) == w->name())))
+                if (!w || (!term.negate ^ (value == w->name())))
                     return false;
-            } else if (!focused || (!term.negate ^ (getProperty(term.prop, win) == getProperty(term.prop, *focused))))
+            } else if (!focused || (!term.negate ^ (value == matchValue(term.prop, *focused, focused_scratch))))
                 return false;
-        } else if (term.prop == HEAD && term.regstr == "[mouse]") {
-            if (!term.negate ^ (getProperty(term.prop, win) == FbTk::StringUtil::number2String(win.screen().getCurrHead())))
+        } else if (term.prop == HEAD && term.mouse) {
+            if (!term.negate ^ (matchValue(term.prop, win, scratch) == numberString(win.screen().getCurrHead(), focused_scratch)))
                 return false;
 
-        } else if (!term.negate ^ term.regexp.match(getProperty(term.prop, win)))
+        } else if (!term.negate ^ term.regexp.match(matchValue(term.prop, win, scratch)))
             return false;
     }
     return true;
@@ -358,6 +498,20 @@ bool ClientPattern::dependsOnCurrentWorkspace() const {
     return false;
 }
 
+bool ClientPattern::literalPrefix(WinProperty prop, FbTk::FbString &prefix) const {
+    Terms::const_iterator it = m_terms.begin(), it_end = m_terms.end();
+    for (; it != it_end; ++it) {
+        const Term &term = *(*it);
+        if (term.prop != prop || term.negate || term.regstr == "[current]")
+            continue;
+
+        prefix = regexLiteralPrefix(term.regstr);
+        if (!prefix.empty())
+            return true;
+    }
+    return false;
+}
+
 // add an expression to match against
 // The first argument is a regular expression, the second is the member
 // function that we wish to match against.
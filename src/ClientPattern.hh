@@ -67,6 +67,14 @@ public:
     /// Does this pattern depend on the current workspace?
     bool dependsOnCurrentWorkspace() const;
 
+    /**
+     * Finds a literal string that prop of every matching window starts with
+     * @param prop the property to look at, CLASS or NAME
+     * @param prefix is set to the literal prefix
+     * @return false if no non-empty prefix can be derived from the terms
+     */
+    bool literalPrefix(WinProperty prop, FbTk::FbString &prefix) const;
+
     /**
      * Add an expression to match against
      * @param str is a regular expression
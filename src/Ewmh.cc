@@ -37,6 +37,8 @@
 #include "FbTk/LayerItem.hh"
 #include "FbTk/Layer.hh"
 #include "FbTk/FbPixmap.hh"
+#include "FbTk/MultLayers.hh"
+#include "FbTk/MemFun.hh"
 
 #include <X11/Xproto.h>
 #include <X11/Xatom.h>
@@ -616,6 +618,8 @@ void Ewmh::initForScreen(BScreen &screen) {
     updateGeometry(screen);
     updateWorkarea(screen);
 
+    join(screen.layerManager().restackSig(),
+         FbTk::MemFunBind<void, Ewmh, BScreen &>(*this, &Ewmh::updateStackingList, screen));
 }
 
 void Ewmh::setupClient(WinClient &winclient) {
@@ -746,27 +750,6 @@ void Ewmh::updateClientList(BScreen &screen) {
     if (screen.isShuttingdown())
         return;
 
-    list<Focusable *> creation_order_list =
-            screen.focusControl().creationOrderList().clientList();
-
-    size_t num = creation_order_list.size();
-    Window *wl = FB_new_nothrow Window[num];
-    if (wl == 0) {
-        _FB_USES_NLS;
-        cerr<<_FB_CONSOLETEXT(Ewmh, OutOfMemoryClientList,
-                      "Fatal: Out of memory, can't allocate for EWMH client list", "")<<endl;
-        return;
-    }
-
-    int win=0;
-    list<Focusable *>::iterator client_it = creation_order_list.begin();
-    list<Focusable *>::iterator client_it_end = creation_order_list.end();
-    for (; client_it != client_it_end; ++client_it) {
-        WinClient *client = dynamic_cast<WinClient *>(*client_it);
-        if (client)
-            wl[win++] = client->window();
-    }
-
     /*  From Extended Window Manager Hints, draft 1.3:
      *
      * _NET_CLIENT_LIST, WINDOW[]/32
@@ -780,14 +763,103 @@ void Ewmh::updateClientList(BScreen &screen) {
      * SHOULD be set and updated by the Window
      * Manager.
      */
-    screen.rootWindow().changeProperty(m_net->client_list,
-                                       XA_WINDOW, 32,
-                                       PropModeReplace, (unsigned char *)wl, num);
-    screen.rootWindow().changeProperty(m_net->client_list_stacking,
-                                       XA_WINDOW, 32,
-                                       PropModeReplace, (unsigned char *)wl, num);
 
-    delete [] wl;
+    // the creation order list only ever holds WinClients
+    const FocusControl::Focusables &creation_order_list =
+            screen.focusControl().creationOrderList().clientList();
+
+    vector<Window> clients;
+    clients.reserve(creation_order_list.size());
+    FocusControl::Focusables::const_iterator client_it = creation_order_list.begin();
+    FocusControl::Focusables::const_iterator client_it_end = creation_order_list.end();
+    for (; client_it != client_it_end; ++client_it)
+        clients.push_back(static_cast<WinClient *>(*client_it)->window());
+
+    vector<Window> &old_clients = m_client_lists[screen.screenNumber()].clients;
+
+    if (clients != old_clients) {
+        // new windows end up at the end of the list, so most of the
+        // time we only need to tell about them
+        if (!old_clients.empty() && old_clients.size() < clients.size() &&
+            std::equal(old_clients.begin(), old_clients.end(), clients.begin())) {
+            screen.rootWindow().changeProperty(m_net->client_list,
+                                               XA_WINDOW, 32, PropModeAppend,
+                                               (unsigned char *)&clients[old_clients.size()],
+                                               clients.size() - old_clients.size());
+        } else {
+            screen.rootWindow().changeProperty(m_net->client_list,
+                                               XA_WINDOW, 32, PropModeReplace,
+                                               (unsigned char *)(clients.empty() ? 0 : &clients[0]),
+                                               clients.size());
+        }
+        old_clients.swap(clients);
+    }
+
+    // the set of windows in the stacking list follows the client list
+    updateStackingList(screen);
+}
+
+void Ewmh::updateStackingList(BScreen &screen) {
+
+    if (screen.isShuttingdown())
+        return;
+
+    // collect the clients of each frame, the active one on top
+    typedef std::map<const FbTk::LayerItem *, vector<Window> > FrameClients;
+    FrameClients frames;
+    vector<Window> stacking;
+
+    const FocusControl::Focusables &creation_order_list =
+            screen.focusControl().creationOrderList().clientList();
+    FocusControl::Focusables::const_iterator client_it = creation_order_list.begin();
+    FocusControl::Focusables::const_iterator client_it_end = creation_order_list.end();
+    for (; client_it != client_it_end; ++client_it) {
+        WinClient *client = static_cast<WinClient *>(*client_it);
+        FluxboxWindow *fbwin = client->fbwindow();
+        if (fbwin == 0) {
+            stacking.push_back(client->window());
+            continue;
+        }
+
+        vector<Window> &windows = frames[&fbwin->layerItem()];
+        if (&fbwin->winClient() == client)
+            windows.push_back(client->window());
+        else
+            windows.insert(windows.begin(), client->window());
+    }
+
+    // layer 0 and the front of each layer are on top
+    FbTk::MultLayers &layers = screen.layerManager();
+    for (int l = ResourceLayer::NUM_LAYERS - 1; l >= 0; --l) {
+        const FbTk::Layer *layer = layers.getLayer(l);
+        if (layer == 0)
+            continue;
+
+        FbTk::Layer::ItemList::const_reverse_iterator it = layer->itemList().rbegin();
+        FbTk::Layer::ItemList::const_reverse_iterator it_end = layer->itemList().rend();
+        for (; it != it_end; ++it) {
+            FrameClients::iterator frame = frames.find(*it);
+            if (frame == frames.end())
+                continue;
+            stacking.insert(stacking.end(), frame->second.begin(), frame->second.end());
+            frames.erase(frame);
+        }
+    }
+
+    // frames that are not stacked (yet) go on top
+    FrameClients::iterator frame = frames.begin();
+    for (; frame != frames.end(); ++frame)
+        stacking.insert(stacking.end(), frame->second.begin(), frame->second.end());
+
+    vector<Window> &old_stacking = m_client_lists[screen.screenNumber()].stacking;
+    if (stacking == old_stacking)
+        return;
+
+    screen.rootWindow().changeProperty(m_net->client_list_stacking,
+                                       XA_WINDOW, 32, PropModeReplace,
+                                       (unsigned char *)(stacking.empty() ? 0 : &stacking[0]),
+                                       stacking.size());
+    old_stacking.swap(stacking);
 }
 
 void Ewmh::updateWorkspaceNames(BScreen &screen) {
@@ -21,9 +21,13 @@
 
 #include "AtomHandler.hh"
 #include "FbTk/FbString.hh"
+#include "FbTk/Signal.hh"
+
+#include <map>
+#include <vector>
 
 /// Implementes Extended Window Manager Hints ( http://www.freedesktop.org/Standards/wm-spec )
-class Ewmh:public AtomHandler {
+class Ewmh:public AtomHandler, private FbTk::SignalTracker {
 public:
 
     Ewmh();
@@ -35,6 +39,7 @@ public:
 
     void updateFocusedWindow(BScreen &screen, Window win);
     void updateClientList(BScreen &screen);
+    void updateStackingList(BScreen &screen);
     void updateWorkspaceNames(BScreen &screen);
     void updateCurrentWorkspace(BScreen &screen);
     void updateWorkspaceCount(BScreen &screen);
@@ -74,4 +79,11 @@ private:
 
     class EwmhAtoms;
     EwmhAtoms* m_net;
+
+    /// what we last wrote to the client list properties of a screen
+    struct ClientLists {
+        std::vector<Window> clients;  ///< _NET_CLIENT_LIST, creation order
+        std::vector<Window> stacking; ///< _NET_CLIENT_LIST_STACKING, bottom to top
+    };
+    std::map<int, ClientLists> m_client_lists; ///< by screen number
 };
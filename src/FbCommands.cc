@@ -29,12 +29,16 @@
 #include "Window.hh"
 #include "Keys.hh"
 #include "MenuCreator.hh"
+#include "Remember.hh"
 
 #include "FbTk/Theme.hh"
 #include "FbTk/Menu.hh"
+#include "FbTk/ImageControl.hh"
 #include "FbTk/CommandParser.hh"
 #include "FbTk/StringUtil.hh"
 #include "FbTk/stringstream.hh"
+#include "FbTk/LatencyStats.hh"
+#include "FbTk/Process.hh"
 
 #include <sys/types.h>
 #include <unistd.h>
@@ -42,6 +46,7 @@
 #include <fstream>
 #include <iostream>
 #include <set>
+#include <vector>
 #include <cstdlib>
 #include <cstring>
 
@@ -86,6 +91,22 @@ void showMenu(BScreen &screen, FbTk::Menu &menu) {
         .placeAndShowMenu(menu, x, y, false);
 }
 
+// write result to _FLUXBOX_ACTION_RESULT property, where
+// 'fluxbox-remote result' picks it up
+void setActionResult(const string &result) {
+
+    Display *dpy = Fluxbox::instance()->display();
+    Atom atom_utf8 = XInternAtom(dpy, "UTF8_STRING", False);
+    Atom atom_fbcmd_result = XInternAtom(dpy, "_FLUXBOX_ACTION_RESULT", False);
+
+    const Fluxbox::ScreenList screens(Fluxbox::instance()->screenList());
+    Fluxbox::ScreenList::const_iterator screen = screens.begin();
+    for (; screen != screens.end(); ++screen) {
+        (*screen)->rootWindow().changeProperty(atom_fbcmd_result, atom_utf8, 8,
+            PropModeReplace, (unsigned char*)result.c_str(), result.size());
+    }
+}
+
 }
 
 namespace FbCommands {
@@ -121,10 +142,6 @@ int ExecuteCmd::run() {
 
     return spawnlp(P_NOWAIT, comspec, comspec, "/c", m_cmd.c_str(), static_cast<void*>(NULL));
 #else
-    pid_t pid = fork();
-    if (pid)
-        return pid;
-
     // 'display' is given as 'host:number.screen'. we want to give the
     // new app a good home, so we remove '.screen' from what is given
     // us from the xserver and replace it with the screen_num of the Screen
@@ -147,19 +164,8 @@ int ExecuteCmd::run() {
     display += '.';
     display += FbTk::StringUtil::number2String(screen_num);
 
-    FbTk::App::setenv("DISPLAY", display.c_str());
-
-    // get shell path from the environment
-    // this process exits immediately, so we don't have to worry about memleaks
-    const char *shell = getenv("SHELL");
-    if (!shell)
-        shell = "/bin/sh";
-
-    setsid();
-    execl(shell, shell, "-c", m_cmd.c_str(), static_cast<void*>(NULL));
-    exit(EXIT_SUCCESS);
-
-    return pid; // compiler happy -> we are happy ;)
+    std::vector<string> env(1, "DISPLAY=" + display);
+    return FbTk::Process::spawnShell(m_cmd, env);
 #endif
 }
 
@@ -539,16 +545,9 @@ void ClientPatternTestCmd::execute() {
     std::string                         result;
     std::string                         pat;
     int                                 opts;
-    Display*                            dpy;
-    Atom                                atom_utf8;
-    Atom                                atom_fbcmd_result;
     Fluxbox::ScreenList::const_iterator screen;
     const Fluxbox::ScreenList           screens(Fluxbox::instance()->screenList());
 
-    dpy = Fluxbox::instance()->display();
-    atom_utf8 = XInternAtom(dpy, "UTF8_STRING", False);
-    atom_fbcmd_result = XInternAtom(dpy, "_FLUXBOX_ACTION_RESULT", False);
-
     FocusableList::parseArgs(m_args, opts, pat);
     ClientPattern cp(pat.c_str());
 
@@ -590,12 +589,53 @@ void ClientPatternTestCmd::execute() {
         result += "\n";
     }
 
+    setActionResult(result);
+}
 
-    // write result to _FLUXBOX_ACTION_RESULT property
-    for (screen = screens.begin(); screen != screens.end(); screen++) {
-        (*screen)->rootWindow().changeProperty(atom_fbcmd_result, atom_utf8, 8,
-            PropModeReplace, (unsigned char*)result.c_str(), result.size());
+REGISTER_COMMAND(rememberstats, FbCommands::RememberStatsCmd, void);
+
+void RememberStatsCmd::execute() {
+    setActionResult(Remember::instance().matchCostReport());
+}
+
+REGISTER_COMMAND_WITH_ARGS(eventstats, FbCommands::EventStatsCmd, void);
+
+void EventStatsCmd::execute() {
+
+    string arg = FbTk::StringUtil::toLower(m_args);
+    if (arg == "on")
+        FbTk::LatencyStats::setEnabled(true);
+    else if (arg == "off")
+        FbTk::LatencyStats::setEnabled(false);
+    else if (arg == "reset")
+        FbTk::LatencyStats::reset();
+
+    string result = FbTk::LatencyStats::report();
+    using FbTk::StringUtil::number2String;
+
+    // the caches which keep the handlers short
+    const Fluxbox::ScreenList screens(Fluxbox::instance()->screenList());
+    Fluxbox::ScreenList::const_iterator screen = screens.begin();
+    for (; screen != screens.end(); ++screen) {
+        const FbTk::ImageControl::CacheStats &image =
+            (*screen)->imageControl().cacheStats();
+        result += "screen " + number2String((*screen)->screenNumber()) +
+            " image cache: hits " + number2String(image.hits) +
+            " misses " + number2String(image.misses) +
+            " evictions " + number2String(image.evictions) +
+            " entries " + number2String(image.entries) +
+            " bytes " + number2String(image.bytes) + "\n";
+
+        const FbTk::Font::WidthCacheStats width =
+            (*screen)->focusedWinFrameTheme()->font().widthCacheStats();
+        result += "screen " + number2String((*screen)->screenNumber()) +
+            " title width cache: hits " + number2String(width.hits) +
+            " misses " + number2String(width.misses) +
+            " evictions " + number2String(width.evictions) +
+            " entries " + number2String(width.entries) + "\n";
     }
+
+    setActionResult(result);
 }
 
 
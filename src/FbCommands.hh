@@ -228,6 +228,21 @@ private:
     std::string m_args;
 };
 
+/// report the cost of matching the patterns of the apps file
+class RememberStatsCmd: public FbTk::Command<void> {
+public:
+    void execute();
+};
+
+/// turn the latency histograms of event handlers and timers on / off, or report them
+class EventStatsCmd: public FbTk::Command<void> {
+public:
+    EventStatsCmd(const std::string& args) : m_args(args) { };
+    void execute();
+private:
+    std::string m_args;
+};
+
 } // end namespace FbCommands
 
 #endif // FBCOMMANDS_HH
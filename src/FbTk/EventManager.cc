@@ -23,6 +23,7 @@
 #include "EventHandler.hh"
 #include "FbWindow.hh"
 #include "App.hh"
+#include "LatencyStats.hh"
 
 #ifdef DEBUG
 #include <iostream>
@@ -39,7 +40,7 @@ EventManager *EventManager::instance() {
 
 EventManager::~EventManager() {
 #ifdef DEBUG
-    if (m_eventhandlers.size() != 0)
+    if (!m_eventhandlers.empty())
         cerr<<"FbTk::EventManager: Warning: unregistered eventhandlers!"<<endl;
 #endif // DEBUG
 }
@@ -54,7 +55,7 @@ void EventManager::add(EventHandler &ev, const FbWindow &win) {
 
 void EventManager::addParent(EventHandler &ev, const FbWindow &win) {
     if (win.window() != 0)
-        m_parent[win.window()] = &ev;
+        m_parent.insert(win.window(), &ev);
 }
 
 void EventManager::remove(const FbWindow &win) {
@@ -62,7 +63,7 @@ void EventManager::remove(const FbWindow &win) {
 }
 
 EventHandler *EventManager::find(Window win) {
-    return m_eventhandlers[win];
+    return m_eventhandlers.find(win);
 }
 
 bool EventManager::grabKeyboard(Window win) {
@@ -129,7 +130,7 @@ Window EventManager::getEventWindow(XEvent &ev) {
 
 void EventManager::registerEventHandler(EventHandler &ev, Window win) {
     if (win != None)
-        m_eventhandlers[win] = &ev;
+        m_eventhandlers.insert(win, &ev);
 }
 
 void EventManager::unregisterEventHandler(Window win) {
@@ -142,23 +143,25 @@ void EventManager::unregisterEventHandler(Window win) {
 void EventManager::dispatch(Window win, XEvent &ev, bool parent) {
     EventHandler *evhand = 0;
     if (parent) {
-        EventHandlerMap::iterator it = m_parent.find(win);
-        if (it == m_parent.end())
-            return;
-        else
-            evhand = it->second;
+        evhand = m_parent.find(win);
     } else {
         win = getEventWindow(ev);
-        EventHandlerMap::iterator it = m_eventhandlers.find(win);
-        if (it == m_eventhandlers.end())
-            return;
-        else
-            evhand = it->second;
+        evhand = m_eventhandlers.find(win);
     }
 
     if (evhand == 0)
         return;
 
+    // the handler might delete itself, so name it before
+    const bool profile = LatencyStats::enabled();
+    uint64_t start = 0;
+    std::string profile_name;
+    if (profile) {
+        profile_name = "handler " + LatencyStats::eventName(ev.type) + " " +
+            LatencyStats::typeName(typeid(*evhand));
+        start = FbTime::mono();
+    }
+
     switch (ev.type) {
     case KeyPress:
         evhand->keyPressEvent(ev.xkey);
@@ -193,6 +196,13 @@ void EventManager::dispatch(Window win, XEvent &ev, bool parent) {
     break;
     };
 
+    if (profile)
+        LatencyStats::add(profile_name, start);
+
+    // nobody listens to children, so spare the round trip
+    if (m_parent.empty())
+        return;
+
     // find out which window is the parent and
     // dispatch event
     Window root, parent_win, *children = 0;
@@ -204,7 +214,7 @@ void EventManager::dispatch(Window win, XEvent &ev, bool parent) {
 
         if (parent_win != 0 &&
             parent_win != root) {
-            if (m_parent[parent_win] == 0)
+            if (m_parent.find(parent_win) == 0)
                 return;
 
             // dispatch event to parent
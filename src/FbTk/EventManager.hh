@@ -22,7 +22,8 @@
 #ifndef FBTK_EVENTMANAGER_HH
 #define FBTK_EVENTMANAGER_HH
 
-#include <map>
+#include "WindowMap.hh"
+
 #include <X11/Xlib.h>
 
 namespace FbTk {
@@ -62,7 +63,7 @@ private:
     ~EventManager();
     void dispatch(Window win, XEvent &event, bool parent = false);
 
-    typedef std::map<Window, EventHandler *> EventHandlerMap;
+    typedef WindowMap<EventHandler> EventHandlerMap;
     EventHandlerMap m_eventhandlers;
     EventHandlerMap m_parent;
 };
@@ -23,10 +23,19 @@
 
 #include "App.hh"
 
+#include <vector>
+#include <algorithm>
+
 namespace FbTk {
 
 Display *FbDrawable::s_display = 0;
 
+namespace {
+
+std::vector<FbDrawable::DestroyHook> s_destroy_hooks;
+
+} // end anonymous namespace
+
 FbDrawable::FbDrawable() {
 
     if (s_display == 0) {
@@ -34,6 +43,19 @@ FbDrawable::FbDrawable() {
     }
 }
 
+void FbDrawable::addDestroyHook(DestroyHook hook) {
+    if (std::find(s_destroy_hooks.begin(), s_destroy_hooks.end(), hook) ==
+        s_destroy_hooks.end())
+        s_destroy_hooks.push_back(hook);
+}
+
+void FbDrawable::drawableDestroyed(Drawable drawable) {
+    if (drawable == 0)
+        return;
+    for (size_t i = 0; i < s_destroy_hooks.size(); ++i)
+        s_destroy_hooks[i](drawable);
+}
+
 void FbDrawable::copyArea(Drawable src, GC gc,
                           int src_x, int src_y,
                           int dest_x, int dest_y,
@@ -69,6 +69,14 @@ public:
     virtual unsigned int height() const = 0;
     virtual unsigned int depth() const = 0;
     static Display *display() { return s_display; }
+
+    /// called with the id of a drawable that is about to be destroyed
+    typedef void (*DestroyHook)(Drawable);
+    /// registers a hook that is told about destroyed drawables,
+    /// e.g. to drop server side objects cached per drawable
+    static void addDestroyHook(DestroyHook hook);
+    /// notifies all hooks that drawable is about to be destroyed
+    static void drawableDestroyed(Drawable drawable);
 protected:
     static Display *s_display; // display connection
 };
@@ -28,6 +28,11 @@
 
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
+
+#ifdef HAVE_XRENDER
+#include <X11/extensions/Xrender.h>
+#endif // HAVE_XRENDER
+
 #include <iostream>
 #include <vector>
 #ifdef HAVE_CSTRING
@@ -35,6 +40,11 @@
 #else
   #include <string.h>
 #endif
+#ifdef HAVE_CSTDLIB
+  #include <cstdlib>
+#else
+  #include <stdlib.h>
+#endif
 
 using std::cerr;
 
@@ -64,6 +74,104 @@ void checkAtoms() {
     }
 }
 
+
+XImage *createImageLike(const XImage *src, unsigned int width, unsigned int height) {
+
+    Display* display = FbTk::App::instance()->display();
+    XImage *image = XCreateImage(display, DefaultVisual(display, DefaultScreen(display)),
+                                 src->depth, src->format, 0, 0,
+                                 width, height, src->bitmap_pad, 0);
+    if (image == 0)
+        return 0;
+
+    // XDestroyImage() releases the data with free()
+    image->data = static_cast<char *>(malloc(image->bytes_per_line * height));
+    if (image->data == 0) {
+        XDestroyImage(image);
+        return 0;
+    }
+
+    return image;
+}
+
+#ifdef HAVE_XRENDER
+
+XRenderPictFormat *findRenderFormat(Display *display, unsigned int depth) {
+
+    if (depth == static_cast<unsigned int>(DefaultDepth(display, DefaultScreen(display))))
+        return XRenderFindVisualFormat(display, DefaultVisual(display, DefaultScreen(display)));
+
+    switch (depth) {
+    case 1:
+        return XRenderFindStandardFormat(display, PictStandardA1);
+    case 8:
+        return XRenderFindStandardFormat(display, PictStandardA8);
+    case 24:
+        return XRenderFindStandardFormat(display, PictStandardRGB24);
+    case 32:
+        return XRenderFindStandardFormat(display, PictStandardARGB32);
+    default:
+        break;
+    }
+    return 0;
+}
+
+/**
+   Renders 'src' into 'dest' on the server side. 'transform' maps
+   coordinates of 'dest' into coordinates of 'src'.
+   @return false if XRender can not do it
+*/
+bool renderTransformed(Drawable src, Drawable dest, unsigned int depth,
+                       unsigned int width, unsigned int height,
+                       const XTransform &transform, bool smooth) {
+
+    if (!FbTk::Transparent::haveRender())
+        return false;
+
+    Display* display = FbTk::App::instance()->display();
+    XRenderPictFormat *format = findRenderFormat(display, depth);
+    if (format == 0)
+        return false;
+
+    XRenderPictureAttributes attr;
+    unsigned long mask = 0;
+#ifdef RepeatPad
+    // avoid dark edges when filtering
+    attr.repeat = RepeatPad;
+    mask |= CPRepeat;
+#endif // RepeatPad
+
+    Picture src_pic = XRenderCreatePicture(display, src, format, mask, &attr);
+    Picture dest_pic = XRenderCreatePicture(display, dest, format, 0, 0);
+
+    XRenderSetPictureTransform(display, src_pic, const_cast<XTransform *>(&transform));
+    XRenderSetPictureFilter(display, src_pic, smooth ? FilterBilinear : FilterNearest, 0, 0);
+    XRenderComposite(display, PictOpSrc, src_pic, None, dest_pic,
+                     0, 0, 0, 0, 0, 0, width, height);
+
+    XRenderFreePicture(display, dest_pic);
+    XRenderFreePicture(display, src_pic);
+
+    return true;
+}
+
+void setTransform(XTransform &transform,
+                  double m00, double m01, double m02,
+                  double m10, double m11, double m12) {
+
+    transform.matrix[0][0] = XDoubleToFixed(m00);
+    transform.matrix[0][1] = XDoubleToFixed(m01);
+    transform.matrix[0][2] = XDoubleToFixed(m02);
+    transform.matrix[1][0] = XDoubleToFixed(m10);
+    transform.matrix[1][1] = XDoubleToFixed(m11);
+    transform.matrix[1][2] = XDoubleToFixed(m12);
+    transform.matrix[2][0] = 0;
+    transform.matrix[2][1] = 0;
+    transform.matrix[2][2] = XDoubleToFixed(1.0);
+}
+
+#endif // HAVE_XRENDER
+
 } // end of anonymous namespace
 
 FbPixmap::FbPixmap():m_pm(0),
@@ -212,7 +320,7 @@ void FbPixmap::copy(Pixmap pm, unsigned int depth, int screen_num) {
 }
 
 void FbPixmap::rotate(FbTk::Orientation orient) {
-    if (orient == ROT0)
+    if (orient == ROT0 || drawable() == 0)
         return;
 
     unsigned int oldw = width(), oldh = height();
@@ -222,67 +330,79 @@ void FbPixmap::rotate(FbTk::Orientation orient) {
     // reverse height/width for new pixmap
     FbPixmap new_pm(drawable(), neww, newh, depth());
 
+    bool done = false;
+
+#ifdef HAVE_XRENDER
+    XTransform transform;
+    switch (orient) {
+    case ROT90:
+        setTransform(transform, 0, 1, 0, -1, 0, neww);
+        break;
+    case ROT180:
+        setTransform(transform, -1, 0, oldw, 0, -1, oldh);
+        break;
+    case ROT270:
+        setTransform(transform, 0, -1, newh, 1, 0, 0);
+        break;
+    default: // kill warning
+        break;
+    }
+    done = renderTransformed(drawable(), new_pm.drawable(), depth(),
+                             neww, newh, transform, false);
+#endif // HAVE_XRENDER
+
     // width|height could be 0. this happens (for example) if
     // the systemtray-tool is ROT90. in that case 'src_image'
     // becomes NULL and caused a SIGSEV upon XDestroyImage()
     // TODO: catch dimensions with '0' earlier?
     //
-    // make an image copy
-    XImage *src_image = XGetImage(display(), drawable(),
-                                  0, 0, // pos
-                                  oldw, oldh, // size
-                                  ~0, // plane mask
-                                  ZPixmap); // format
-    if (src_image) {
+    // make an image copy, rotate it on the client side and
+    // upload the result in one go
+    XImage *src_image = 0;
+    if (!done) {
+        src_image = XGetImage(display(), drawable(),
+                              0, 0, // pos
+                              oldw, oldh, // size
+                              ~0, // plane mask
+                              ZPixmap); // format
+    }
 
-        GContext gc(drawable());
-
-        if (orient == ROT180) {
-            unsigned int srcx, srcy, destx, desty;
-            for (srcy = 0, desty = oldh; srcy < oldh; ++srcy, --desty) {
-                for (srcx = 0, destx = oldw; srcx < oldw; ++srcx, --destx) {
-                    gc.setForeground(XGetPixel(src_image, srcx, srcy));
-                    XDrawPoint(display(), new_pm.drawable(), gc.gc(), destx, desty);
-                }
-            }
-        } else {
-            // need to flip x and y
-
-            // set start, end and direction based on rotation
-            // NOTE that startx etc are in the direction of the OLD pixmap
-            unsigned int startx = 0, starty = 0;
-            int dirx = 0, diry = 0;
-            switch (orient) {
-            case ROT90:
-                startx = neww-1;
-                starty = 0;
-                dirx = -1;
-                diry = 1;
-                break;
-            case ROT270:
-                startx = 0;
-                starty = newh-1;
-                dirx = 1;
-                diry = -1;
-                break;
-            default: // kill warning
-                break;
-            }
+    XImage *dest_image = 0;
+    if (src_image)
+        dest_image = createImageLike(src_image, neww, newh);
 
+    if (dest_image) {
 
-            // copy new area
-            unsigned int srcx, srcy, destx, desty;
-            for (srcy = 0, destx = startx; srcy < oldh; ++srcy, destx+=dirx) {
-                for (srcx = 0, desty = starty; srcx < oldw; ++srcx, desty+=diry) {
-                    gc.setForeground(XGetPixel(src_image, srcx, srcy));
-                    XDrawPoint(display(), new_pm.drawable(), gc.gc(), destx, desty);
+        unsigned int srcx, srcy;
+        for (srcy = 0; srcy < oldh; ++srcy) {
+            for (srcx = 0; srcx < oldw; ++srcx) {
+                unsigned long pixel = XGetPixel(src_image, srcx, srcy);
+                switch (orient) {
+                case ROT90:
+                    XPutPixel(dest_image, neww - 1 - srcy, srcx, pixel);
+                    break;
+                case ROT180:
+                    XPutPixel(dest_image, oldw - 1 - srcx, oldh - 1 - srcy, pixel);
+                    break;
+                case ROT270:
+                    XPutPixel(dest_image, srcy, newh - 1 - srcx, pixel);
+                    break;
+                default: // kill warning
+                    break;
                 }
             }
         }
 
-        XDestroyImage(src_image);
+        GContext gc(drawable());
+        XPutImage(display(), new_pm.drawable(), gc.gc(), dest_image,
+                  0, 0, 0, 0, neww, newh);
+
+        XDestroyImage(dest_image);
     }
 
+    if (src_image)
+        XDestroyImage(src_image);
+
     // free old pixmap and set new from new_pm
     free();
 
@@ -298,35 +418,56 @@ void FbPixmap::scale(unsigned int dest_width, unsigned int dest_height) {
         (dest_width == width() && dest_height == height()))
         return;
 
-    XImage *src_image = XGetImage(display(), drawable(),
-                                  0, 0, // pos
-                                  width(), height(), // size
-                                  ~0, // plane mask
-                                  ZPixmap); // format
-    if (src_image == 0)
-        return;
-
     // create new pixmap with dest size
     FbPixmap new_pm(drawable(), dest_width, dest_height, depth());
 
-    GContext gc(drawable());
     // calc zoom
     float zoom_x = static_cast<float>(width())/static_cast<float>(dest_width);
     float zoom_y = static_cast<float>(height())/static_cast<float>(dest_height);
 
-    // start scaling
-    float src_x = 0, src_y = 0;
-    for (unsigned int tx=0; tx < dest_width; ++tx, src_x += zoom_x) {
-        src_y = 0;
-        for (unsigned int ty=0; ty < dest_height; ++ty, src_y += zoom_y) {
-            gc.setForeground(XGetPixel(src_image,
-                                       static_cast<int>(src_x),
-                                       static_cast<int>(src_y)));
-            XDrawPoint(display(), new_pm.drawable(), gc.gc(), tx, ty);
+    bool done = false;
+
+#ifdef HAVE_XRENDER
+    XTransform transform;
+    setTransform(transform, zoom_x, 0, 0, 0, zoom_y, 0);
+    done = renderTransformed(drawable(), new_pm.drawable(), depth(),
+                             dest_width, dest_height, transform, true);
+#endif // HAVE_XRENDER
+
+    if (!done) {
+        XImage *src_image = XGetImage(display(), drawable(),
+                                      0, 0, // pos
+                                      width(), height(), // size
+                                      ~0, // plane mask
+                                      ZPixmap); // format
+        if (src_image == 0)
+            return;
+
+        XImage *dest_image = createImageLike(src_image, dest_width, dest_height);
+        if (dest_image == 0) {
+            XDestroyImage(src_image);
+            return;
         }
-    }
 
-    XDestroyImage(src_image);
+        // start scaling
+        float src_x = 0, src_y = 0;
+        for (unsigned int tx=0; tx < dest_width; ++tx, src_x += zoom_x) {
+            src_y = 0;
+            for (unsigned int ty=0; ty < dest_height; ++ty, src_y += zoom_y) {
+                XPutPixel(dest_image, tx, ty,
+                          XGetPixel(src_image,
+                                    static_cast<int>(src_x),
+                                    static_cast<int>(src_y)));
+            }
+        }
+
+        GContext gc(drawable());
+        XPutImage(display(), new_pm.drawable(), gc.gc(), dest_image,
+                  0, 0, 0, 0, dest_width, dest_height);
+
+        XDestroyImage(dest_image);
+        XDestroyImage(src_image);
+    }
 
     // free old pixmap and set new from new_pm
     free();
@@ -487,8 +628,10 @@ Pixmap FbPixmap::getRootPixmap(int screen_num, bool force_update) {
 }
 
 void FbPixmap::free() {
-    if (!m_dont_free && m_pm != 0)
+    if (!m_dont_free && m_pm != 0) {
+        drawableDestroyed(m_pm);
         XFreePixmap(display(), m_pm);
+    }
 
     /* note: m_dont_free shouldnt be required anywhere else,
        because then free() isn't being called appropriately! */
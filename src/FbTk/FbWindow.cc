@@ -142,6 +142,7 @@ FbWindow::~FbWindow() {
     if (m_window != 0) {
         // so we don't get any dangling eventhandler for this window
         FbTk::EventManager::instance()->remove(m_window);
+        drawableDestroyed(m_window);
         if (m_destroy)
             XDestroyWindow(display(), m_window);
     }
@@ -413,8 +414,11 @@ FbWindow &FbWindow::operator = (Window win) {
 
 void FbWindow::setNew(Window win) {
 
-    if (m_window != 0 && m_destroy)
-        XDestroyWindow(display(), m_window);
+    if (m_window != 0) {
+        drawableDestroyed(m_window);
+        if (m_destroy)
+            XDestroyWindow(display(), m_window);
+    }
 
     m_window = win;
 
@@ -521,7 +525,7 @@ FbTk::FbString FbWindow::textProperty(Atom prop,bool*exists) const {
     static const Atom utf8string = XInternAtom(display(), "UTF8_STRING", False);
 
     if (exists) *exists=false;
-    if (XGetTextProperty(display(), window(), &text_prop, prop) == 0 || text_prop.value == 0 || text_prop.nitems == 0) {
+    if (!rawTextProperty(prop, text_prop) || text_prop.value == 0 || text_prop.nitems == 0) {
         return "";
     }
 
@@ -558,6 +562,35 @@ FbTk::FbString FbWindow::textProperty(Atom prop,bool*exists) const {
     return ret;
 }
 
+bool FbWindow::rawTextProperty(Atom prop, XTextProperty &text_prop) const {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = 0;
+
+    text_prop.value = 0;
+    text_prop.encoding = None;
+    text_prop.format = 0;
+    text_prop.nitems = 0;
+
+    // what XGetTextProperty does, through property()
+    if (!property(prop, 0, 1000000, False, AnyPropertyType,
+                  &type, &format, &nitems, &bytes_after, &data))
+        return false;
+
+    if (type == None) {
+        if (data != 0)
+            XFree(data);
+        return false;
+    }
+
+    text_prop.value = data;
+    text_prop.encoding = type;
+    text_prop.format = format;
+    text_prop.nitems = nitems;
+    return true;
+}
+
 bool FbWindow::property(Atom prop,
                         long long_offset, long long_length,
                         bool do_delete,
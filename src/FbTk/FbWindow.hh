@@ -25,6 +25,8 @@
 #include "FbDrawable.hh"
 #include "FbString.hh"
 
+#include <X11/Xutil.h>
+
 #include <memory>
 #include <string>
 #include <set>
@@ -150,26 +152,28 @@ public:
 
     void reparent(const FbWindow &parent, int x, int y, bool continuing = true);
 
-    bool property(Atom property,
-                  long long_offset, long long_length,
-                  bool do_delete,
-                  Atom req_type,
-                  Atom *actual_type_return,
-                  int *actual_format_return,
-                  unsigned long *nitems_return,
-                  unsigned long *bytes_after_return,
-                  unsigned char **prop_return) const;
+    virtual bool property(Atom property,
+                          long long_offset, long long_length,
+                          bool do_delete,
+                          Atom req_type,
+                          Atom *actual_type_return,
+                          int *actual_format_return,
+                          unsigned long *nitems_return,
+                          unsigned long *bytes_after_return,
+                          unsigned char **prop_return) const;
 
-    void changeProperty(Atom property, Atom type,
-                        int format,
-                        int mode,
-                        unsigned char *data,
-                        int nelements);
+    virtual void changeProperty(Atom property, Atom type,
+                                int format,
+                                int mode,
+                                unsigned char *data,
+                                int nelements);
 
-    void deleteProperty(Atom property);
+    virtual void deleteProperty(Atom property);
 
     long cardinalProperty(Atom property, bool*exists=NULL) const;
     FbTk::FbString textProperty(Atom property,bool*exists=NULL) const;
+    /// like XGetTextProperty, text_prop.value has to be freed with XFree
+    bool rawTextProperty(Atom property, XTextProperty &text_prop) const;
 
     void addToSaveSet();
     void removeFromSaveSet();
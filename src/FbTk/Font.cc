@@ -41,6 +41,7 @@
 #include <cstdlib>
 #include <list>
 #include <map>
+#include <vector>
 #include <typeinfo>
 #include <langinfo.h>
 
@@ -62,6 +63,16 @@ typedef StringMap::iterator StringMapIt;
 typedef map<string, FbTk::FontImp* > FontCache;
 typedef FontCache::iterator FontCacheIt;
 
+// FNV-1a, the strings we measure are short labels
+unsigned int hashText(const char *text, unsigned int len) {
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 
 void resetEffects(FbTk::Font& font) {
     int nr_scr = DefaultScreen(FbTk::App::instance()->display());
@@ -86,6 +97,75 @@ bool s_utf8mode = false; // should the font use utf8 font imp
 
 namespace FbTk {
 
+/**
+   Direct mapped cache of text widths for one FontImp. Menus, the iconbar
+   and the titlebars measure the same labels over and over again while
+   laying out, which for xft means glyph extents and a locale conversion
+   each time.
+*/
+class TextWidthCache {
+public:
+    enum {
+        SLOTS = 512,       ///< number of cached strings, power of two
+        MAX_LENGTH = 256   ///< longer strings are not worth keeping around
+    };
+
+    struct Slot {
+        Slot(): used(false), hash(0), width(0) { }
+        bool used;
+        unsigned int hash;
+        std::string text;
+        unsigned int width;
+    };
+
+    TextWidthCache(): slots(SLOTS) {
+        stats.hits = stats.misses = stats.evictions = stats.entries = 0;
+    }
+
+    unsigned int textWidth(const FontImp &imp, const char *text, unsigned int len) {
+        if (len > MAX_LENGTH)
+            return imp.textWidth(text, len);
+
+        unsigned int hash = hashText(text, len);
+        Slot &slot = slots[hash & (SLOTS - 1)];
+        if (slot.used && slot.hash == hash &&
+            slot.text.size() == len && slot.text.compare(0, len, text, len) == 0) {
+            stats.hits++;
+            return slot.width;
+        }
+
+        stats.misses++;
+        if (slot.used)
+            stats.evictions++;
+        else
+            stats.entries++;
+
+        slot.used = true;
+        slot.hash = hash;
+        slot.text.assign(text, len);
+        slot.width = imp.textWidth(text, len);
+        return slot.width;
+    }
+
+    std::vector<Slot> slots;
+    Font::WidthCacheStats stats;
+};
+
+namespace {
+
+// the width caches belong to the fontimps, which are shared between fonts
+typedef map<FontImp*, TextWidthCache*> WidthCaches;
+WidthCaches s_width_caches;
+
+TextWidthCache *widthCache(FontImp *imp) {
+    TextWidthCache *&cache = s_width_caches[imp];
+    if (cache == 0)
+        cache = new TextWidthCache();
+    return cache;
+}
+
+} // end anonymous namespace
+
 const char Font::DEFAULT_FONT[] = "__DEFAULT__";
 
 
@@ -102,6 +182,11 @@ void Font::shutdown() {
             delete font;
         }
     }
+
+    WidthCaches::iterator wit = s_width_caches.begin();
+    for (; wit != s_width_caches.end(); ++wit)
+        delete wit->second;
+    s_width_caches.clear();
 }
 
 bool Font::multibyte() {
@@ -115,6 +200,7 @@ bool Font::utf8() {
 
 Font::Font(const char *name):
     m_fontimp(0),
+    m_width_cache(0),
     m_shadow(false), m_shadow_color("black", DefaultScreen(App::instance()->display())),
     m_shadow_offx(2), m_shadow_offy(2),
     m_halo(false), m_halo_color("white", DefaultScreen(App::instance()->display()))
@@ -160,6 +246,7 @@ bool Font::load(const string &name) {
             (cache_entry = s_font_cache.find(lookup_entry->second)) != s_font_cache.end()) {
         m_fontstr = cache_entry->first;
         m_fontimp = cache_entry->second;
+        m_width_cache = widthCache(m_fontimp);
         resetEffects(*this);
         return true;
      }
@@ -178,6 +265,7 @@ bool Font::load(const string &name) {
         if ((cache_entry = s_font_cache.find(*name_it)) != s_font_cache.end()) {
             m_fontstr = cache_entry->first;
             m_fontimp = cache_entry->second;
+            m_width_cache = widthCache(m_fontimp);
             s_lookup_map[name] = m_fontstr;
             resetEffects(*this);
             return true;
@@ -227,6 +315,7 @@ bool Font::load(const string &name) {
         if (tmp_font && tmp_font->load(realname.c_str())) {
             s_lookup_map[name] = (*name_it);
             m_fontimp = tmp_font;
+            m_width_cache = widthCache(m_fontimp);
             s_font_cache[(*name_it)] = tmp_font;
             m_fontstr = name;
             resetEffects(*this);
@@ -240,13 +329,23 @@ bool Font::load(const string &name) {
 }
 
 unsigned int Font::textWidth(const char* text, unsigned int size) const {
-    return m_fontimp->textWidth(text, size);
+    if (m_width_cache == 0)
+        return m_fontimp->textWidth(text, size);
+    return m_width_cache->textWidth(*m_fontimp, text, size);
 }
 
 unsigned int Font::textWidth(const BiDiString &text) const {
     return textWidth(text.visual().c_str(), text.visual().size());
 }
 
+Font::WidthCacheStats Font::widthCacheStats() const {
+    if (m_width_cache == 0) {
+        WidthCacheStats stats = { 0, 0, 0, 0 };
+        return stats;
+    }
+    return m_width_cache->stats;
+}
+
 unsigned int Font::height() const {
     return m_fontimp->height();
 }
@@ -32,6 +32,7 @@ namespace FbTk {
 
 class FontImp;
 class FbDrawable;
+class TextWidthCache;
 
 /**
    Handles the client to fontimp bridge.
@@ -41,6 +42,13 @@ public:
 
     static const char DEFAULT_FONT[];
 
+    /// statistics of the text width cache of a font
+    struct WidthCacheStats {
+        unsigned long hits;      ///< textWidth calls served from the cache
+        unsigned long misses;    ///< textWidth calls that had to measure
+        unsigned long evictions; ///< cached widths replaced by other strings
+        unsigned long entries;   ///< number of cached widths
+    };
 
     /// called at FbTk::App destruction time, cleans up cache
     static void shutdown();
@@ -76,6 +84,9 @@ public:
     unsigned int textWidth(const char* text, unsigned int size) const;
     unsigned int textWidth(const BiDiString &text) const;
 
+    /// @return statistics of the text width cache shared by users of this font
+    WidthCacheStats widthCacheStats() const;
+
     unsigned int height() const;
     int ascent() const;
     int descent() const;
@@ -111,8 +122,8 @@ public:
     bool hasShadow() const { return m_shadow; }
     bool hasHalo() const { return m_halo; }
 private:
-
     FbTk::FontImp* m_fontimp; ///< font implementation
+    TextWidthCache *m_width_cache; ///< measured text widths of m_fontimp
     std::string m_fontstr; ///< font name
 
     bool m_shadow; ///< shadow text
@@ -27,13 +27,22 @@
 #include "TextureRender.hh"
 #include "Texture.hh"
 #include "App.hh"
+#include "FbDrawable.hh"
 #include "SimpleCommand.hh"
 #include "I18n.hh"
 
+#include <X11/Xutil.h>
+
 #ifdef HAVE_SYS_TYPES_H
 #include <sys/types.h>
 #endif // HAVE_SYS_TYPES_H
 
+#ifdef HAVE_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif // HAVE_XSHM
+
 #ifdef HAVE_CSTDLIB
   #include <cstdlib>
 #else
@@ -46,10 +55,10 @@
 #endif
 
 #include <iostream>
+#include <algorithm>
 
 using std::cerr;
 using std::endl;
-using std::list;
 
 namespace FbTk {
 
@@ -61,6 +70,17 @@ bool s_timed_cache = true;
 bool s_timed_cache = false;
 #endif // TIMEDCACHE
 
+// smaller images are not worth the extra work of shared memory
+const size_t SHM_MIN_IMAGE_SIZE = 64 * 1024;
+const size_t SHM_MAX_SEGMENTS = 4;
+
+bool s_shm_error = false;
+
+int handleShmError(Display *, XErrorEvent *) {
+    s_shm_error = true;
+    return 0;
+}
+
 
 void initColortables(unsigned char red[256], unsigned char green[256], unsigned char blue[256],
       int red_bits, int green_bits, int blue_bits) {
@@ -157,17 +177,74 @@ void allocateUnallocatedColors(std::vector<XColor> colors, Display* dpy, Colorma
 } // end anonymous namespace
 
 struct ImageControl::Cache {
+
+    /// fill in the fields which identify a rendered texture
+    void setKey(unsigned int w, unsigned int h,
+                const Texture &text, Orientation o) {
+
+        width = w;
+        height = h;
+        orient = o;
+        texture = text.type();
+        texture_pixmap = text.pixmap().drawable();
+
+        // the colors do not matter if the texture is a pixmap and
+        // the second color is only used by gradients
+        if (texture_pixmap != None) {
+            pixel1 = pixel2 = 0l;
+        } else {
+            pixel1 = text.color().pixel();
+            if (texture & Texture::GRADIENT)
+                pixel2 = text.colorTo().pixel();
+            else
+                pixel2 = 0l;
+        }
+
+        hash = width;
+        hash = hash * 31 + height;
+        hash = hash * 31 + orient;
+        hash = hash * 31 + texture;
+        hash = hash * 31 + pixel1;
+        hash = hash * 31 + pixel2;
+        hash = hash * 31 + texture_pixmap;
+        hash ^= hash >> 16;
+    }
+
+    bool sameKey(const Cache &other) const {
+        return hash == other.hash &&
+            width == other.width &&
+            height == other.height &&
+            orient == other.orient &&
+            texture == other.texture &&
+            pixel1 == other.pixel1 &&
+            pixel2 == other.pixel2 &&
+            texture_pixmap == other.texture_pixmap;
+    }
+
     Pixmap pixmap;
     Pixmap texture_pixmap;
     Orientation orient;
     unsigned int count, width, height;
     unsigned long pixel1, pixel2, texture;
+    unsigned long size; ///< estimated size of 'pixmap' in bytes
+    unsigned long hash;
+    Cache *next; ///< next item in the same hash bucket
+    CacheList::iterator unused_it; ///< position in m_cache_unused, valid if count == 0
+};
+
+struct ImageControl::ShmSegment {
+#ifdef HAVE_XSHM
+    XShmSegmentInfo info;
+#endif // HAVE_XSHM
+    size_t size;
+    unsigned long serial; ///< last request which reads from the segment
 };
 
 ImageControl::ImageControl(int screen_num,
                            int cpc, unsigned long cache_timeout, unsigned long cmax):
     m_colors_per_channel(cpc),
-    m_screen_num(screen_num) {
+    m_screen_num(screen_num),
+    m_shm_usable(false) {
 
     Display *disp = FbTk::App::instance()->display();
 
@@ -175,7 +252,9 @@ ImageControl::ImageControl(int screen_num,
     m_visual = DefaultVisual(disp, screen_num);
     m_colormap = DefaultColormap(disp, screen_num);
 
-    cache_max = cmax;
+    m_cache_max = cmax * 1024;
+    m_cache_stats.hits = m_cache_stats.misses = m_cache_stats.evictions = 0;
+    m_cache_stats.entries = m_cache_stats.bytes = 0;
 
     if (cache_timeout && s_timed_cache) {
         m_timer.setTimeout(cache_timeout * FbTk::FbTime::IN_MILLISECONDS);
@@ -185,6 +264,10 @@ ImageControl::ImageControl(int screen_num,
     }
 
     createColorTable();
+
+#ifdef HAVE_XSHM
+    m_shm_usable = XShmQueryExtension(disp);
+#endif // HAVE_XSHM
 }
 
 
@@ -201,68 +284,39 @@ ImageControl::~ImageControl() {
         XFreeColors(disp, m_colormap, &pixels[0], pixels.size(), 0);
     }
 
-    if (!cache.empty()) {
-        CacheList::iterator it = cache.begin();
-        CacheList::iterator it_end = cache.end();
-        for (; it != it_end; ++it) {
-            XFreePixmap(disp, (*it)->pixmap);
-            delete (*it);
-        }
+    PixmapCacheMap::iterator it = m_cache_pixmaps.begin();
+    PixmapCacheMap::iterator it_end = m_cache_pixmaps.end();
+    for (; it != it_end; ++it) {
+        FbDrawable::drawableDestroyed(it->first);
+        XFreePixmap(disp, it->first);
+        delete it->second;
     }
+
+    for (size_t i = 0; i < m_shm_segments.size(); ++i)
+        destroyShmSegment(m_shm_segments[i]);
 }
 
 
 Pixmap ImageControl::searchCache(unsigned int width, unsigned int height,
-                                 const Texture &text, FbTk::Orientation orient) const {
-
-    if (text.pixmap().drawable() != None) {
-        // do comparsion with width/height and texture_pixmap
-        CacheList::iterator it = cache.begin();
-        CacheList::iterator it_end = cache.end();
-        for (; it != it_end; ++it) {
-            if ((*it)->texture_pixmap == text.pixmap().drawable() &&
-                (*it)->orient == orient &&
-                (*it)->width == width &&
-                (*it)->height == height &&
-                (*it)->texture == text.type()) {
-                (*it)->count++;
-                return (*it)->pixmap;
-            }
-        }
+                                 const Texture &text, FbTk::Orientation orient) {
+
+    if (m_cache_buckets.empty())
         return None;
-    }
 
-    /*    Cache tmp;
-    tmp.texture_pixmap = text.pixmap().drawable();
-    tmp.width = width;
-    tmp.height = height;
-    tmp.texture = text.type();
-    tmp.pixel1 = text.color().pixel();
-    tmp.pixel2 = text.colorTo().pixel();
-    */
-
-    CacheList::iterator it = cache.begin();
-    CacheList::iterator it_end = cache.end();
-    for (; it != it_end; ++it) {
-        if (((*it)->width == width) &&
-            ((*it)->orient == orient) &&
-            ((*it)->height == height) &&
-            ((*it)->texture == text.type()) &&
-            ((*it)->pixel1 == text.color().pixel())) {
-            if (text.type() & FbTk::Texture::GRADIENT) {
-                if ((*it)->pixel2 == text.colorTo().pixel()) {
-                    (*it)->count++;
-                    return (*it)->pixmap;
-                }
-            } else {
-                (*it)->count++;
-                return (*it)->pixmap;
-            }
+    Cache key;
+    key.setKey(width, height, text, orient);
+
+    Cache *item = m_cache_buckets[key.hash % m_cache_buckets.size()];
+    for (; item != 0; item = item->next) {
+        if (item->sameKey(key)) {
+            if (item->count == 0)
+                m_cache_unused.erase(item->unused_it);
+            item->count++;
+            return item->pixmap;
         }
     }
 
     return None;
-
 }
 
 
@@ -283,37 +337,30 @@ Pixmap ImageControl::renderImage(unsigned int width, unsigned int height,
     // search cache first
     Pixmap pixmap = searchCache(width, height, texture, orient);
     if (pixmap) {
+        m_cache_stats.hits++;
         return pixmap; // return cache item
     }
 
+    m_cache_stats.misses++;
+
     // render new image
 
     TextureRender image(*this, width, height, orient);
     pixmap = image.render(texture);
 
     if (pixmap) {
-        // create new cache item and add it to cache list
+        // create new cache item and add it to the cache
 
         Cache *tmp = new Cache;
 
+        tmp->setKey(width, height, texture, orient);
         tmp->pixmap = pixmap;
-        tmp->texture_pixmap = texture.pixmap().drawable();
-        tmp->orient = orient;
-        tmp->width = width;
-        tmp->height = height;
         tmp->count = 1;
-        tmp->texture = texture.type();
-        tmp->pixel1 = texture.color().pixel();
-
-        if (texture.type() & FbTk::Texture::GRADIENT)
-            tmp->pixel2 = texture.colorTo().pixel();
-        else
-            tmp->pixel2 = 0l;
-
-        cache.push_back(tmp);
+        tmp->size = static_cast<unsigned long>(width) * height *
+            ((bits_per_pixel + 7) / 8);
 
-        if (cache.size() > cache_max)
-            cleanCache();
+        insertCache(tmp);
+        trimCache();
 
         return pixmap;
     }
@@ -326,26 +373,193 @@ void ImageControl::removeImage(Pixmap pixmap) {
     if (!pixmap)
         return;
 
-    CacheList::iterator it = cache.begin();
-    CacheList::iterator it_end = cache.end();
-    for (; it != it_end; ++it) {
-        if ((*it)->pixmap == pixmap) {
-            if ((*it)->count) {
-                (*it)->count--;
-                if (s_timed_cache) {
-                    cleanCache();
-                    return;
-                }
+    PixmapCacheMap::iterator it = m_cache_pixmaps.find(pixmap);
+    if (it == m_cache_pixmaps.end())
+        return;
+
+    Cache *item = it->second;
+    if (item->count == 0)
+        return;
+
+    item->count--;
+    if (item->count == 0) {
+        // keep the pixmap around for reuse until the cache gets too big
+        item->unused_it = m_cache_unused.insert(m_cache_unused.end(), item);
+        trimCache();
+    }
+}
+
+
+XImage *ImageControl::createImage(unsigned int width, unsigned int height) {
+
+    Display *disp = FbTk::App::instance()->display();
+
+#ifdef HAVE_XSHM
+    if (m_shm_usable) {
+        XImage *image = XShmCreateImage(disp, m_visual, m_screen_depth,
+                                        ZPixmap, 0, 0, width, height);
+        if (image) {
+            const size_t size = static_cast<size_t>(image->bytes_per_line) * height;
+            ShmSegment *segment = 0;
+            if (size >= SHM_MIN_IMAGE_SIZE)
+                segment = acquireShmSegment(size);
+
+            if (segment) {
+                image->data = segment->info.shmaddr;
+                image->obdata = reinterpret_cast<char *>(&segment->info);
+                return image;
             }
 
-            if ((*it)->count <= 0)
-                cleanCache();
+            XDestroyImage(image);
+        }
+    }
+#endif // HAVE_XSHM
+
+    XImage *image = XCreateImage(disp, m_visual, m_screen_depth, ZPixmap, 0, 0,
+                                 width, height, 32, 0);
+    if (image)
+        image->data = new char[image->bytes_per_line * (height + 1)];
 
-            return;
+    return image;
+}
+
+void ImageControl::putImage(Drawable drawable, XImage *image) {
+
+    Display *disp = FbTk::App::instance()->display();
+    GC gc = DefaultGC(disp, m_screen_num);
+
+#ifdef HAVE_XSHM
+    if (image->obdata) {
+        for (size_t i = 0; i < m_shm_segments.size(); ++i) {
+            ShmSegment *segment = m_shm_segments[i];
+            if (image->obdata == reinterpret_cast<char *>(&segment->info)) {
+                segment->serial = NextRequest(disp);
+                break;
+            }
         }
+
+        XShmPutImage(disp, drawable, gc, image, 0, 0, 0, 0,
+                     image->width, image->height, False);
+        destroyImage(image);
+        return;
+    }
+#endif // HAVE_XSHM
+
+    XPutImage(disp, drawable, gc, image, 0, 0, 0, 0, image->width, image->height);
+    destroyImage(image);
+}
+
+void ImageControl::destroyImage(XImage *image) {
+
+    // shared memory is owned by m_shm_segments
+    if (image->obdata == 0)
+        delete [] image->data;
+
+    image->data = 0;
+    image->obdata = 0;
+    XDestroyImage(image);
+}
+
+ImageControl::ShmSegment *ImageControl::acquireShmSegment(size_t size) {
+
+    if (!m_shm_usable)
+        return 0;
+
+    Display *disp = FbTk::App::instance()->display();
+
+    ShmSegment *segment = 0;
+    size_t i;
+    for (i = 0; i < m_shm_segments.size(); ++i) {
+        if (m_shm_segments[i]->size >= size &&
+            (segment == 0 || m_shm_segments[i]->size < segment->size)) {
+            segment = m_shm_segments[i];
+        }
+    }
+
+    if (segment == 0) {
+        if (m_shm_segments.size() >= SHM_MAX_SEGMENTS) {
+            // make room by dropping the smallest segment
+            size_t smallest = 0;
+            for (i = 1; i < m_shm_segments.size(); ++i) {
+                if (m_shm_segments[i]->size < m_shm_segments[smallest]->size)
+                    smallest = i;
+            }
+            destroyShmSegment(m_shm_segments[smallest]);
+            m_shm_segments.erase(m_shm_segments.begin() + smallest);
+        }
+
+        segment = createShmSegment(size);
+        if (segment)
+            m_shm_segments.push_back(segment);
+        return segment;
+    }
+
+    // the server might still read the previous image from the segment
+    if (static_cast<long>(LastKnownRequestProcessed(disp) - segment->serial) < 0)
+        XSync(disp, False);
+
+    return segment;
+}
+
+ImageControl::ShmSegment *ImageControl::createShmSegment(size_t size) {
+#ifdef HAVE_XSHM
+    Display *disp = FbTk::App::instance()->display();
+
+    // round up, so the segment can be reused for slightly bigger images
+    const size_t granularity = 64 * 1024;
+    size = ((size + granularity - 1) / granularity) * granularity;
+
+    ShmSegment *segment = new ShmSegment;
+    segment->size = size;
+    segment->serial = 0;
+    segment->info.readOnly = True;
+    segment->info.shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (segment->info.shmid < 0) {
+        delete segment;
+        return 0;
+    }
+
+    segment->info.shmaddr = static_cast<char *>(shmat(segment->info.shmid, 0, 0));
+    if (segment->info.shmaddr == reinterpret_cast<char *>(-1)) {
+        shmctl(segment->info.shmid, IPC_RMID, 0);
+        delete segment;
+        return 0;
+    }
+
+    // attaching fails for remote displays, that is only reported as
+    // an asynchronous error
+    XSync(disp, False);
+    s_shm_error = false;
+    XErrorHandler old = XSetErrorHandler(handleShmError);
+    XShmAttach(disp, &segment->info);
+    XSync(disp, False);
+    XSetErrorHandler(old);
+
+    // the segment is removed once the server and we detached
+    shmctl(segment->info.shmid, IPC_RMID, 0);
+
+    if (s_shm_error) {
+        shmdt(segment->info.shmaddr);
+        delete segment;
+        m_shm_usable = false;
+        return 0;
     }
+
+    return segment;
+#else
+    return 0;
+#endif // HAVE_XSHM
 }
 
+void ImageControl::destroyShmSegment(ShmSegment *segment) {
+#ifdef HAVE_XSHM
+    Display *disp = FbTk::App::instance()->display();
+    XShmDetach(disp, &segment->info);
+    XSync(disp, False);
+    shmdt(segment->info.shmaddr);
+#endif // HAVE_XSHM
+    delete segment;
+}
 
 void ImageControl::colorTables(const unsigned char **rmt, const unsigned char **gmt,
                                const unsigned char **bmt,
@@ -409,26 +623,67 @@ void ImageControl::installRootColormap() {
 
 
 void ImageControl::cleanCache() {
-    Display *disp = FbTk::App::instance()->display();
-    list<CacheList::iterator> deadlist;
-    CacheList::iterator it = cache.begin();
-    CacheList::iterator it_end = cache.end();
-    for (; it != it_end; ++it) {
-        Cache *tmp = (*it);
-        if (tmp->count <= 0) {
-            XFreePixmap(disp, tmp->pixmap);
-            deadlist.push_back(it);
-            delete tmp;
-            tmp=0;
-        }
+    while (!m_cache_unused.empty())
+        eraseCache(m_cache_unused.front());
+}
+
+void ImageControl::trimCache() {
+    while (m_cache_stats.bytes > m_cache_max && !m_cache_unused.empty()) {
+        eraseCache(m_cache_unused.front());
+        m_cache_stats.evictions++;
     }
+}
+
+void ImageControl::insertCache(Cache *item) {
 
-    list<CacheList::iterator>::iterator dead_it = deadlist.begin();
-    list<CacheList::iterator>::iterator dead_it_end = deadlist.end();
-    for (; dead_it != dead_it_end; ++dead_it) {
-        cache.erase(*dead_it);
+    // keep the load factor of the hash index below 1
+    if (m_cache_pixmaps.size() >= m_cache_buckets.size())
+        rehashCache(std::max(static_cast<size_t>(64), m_cache_buckets.size() * 2));
+
+    Cache *&bucket = m_cache_buckets[item->hash % m_cache_buckets.size()];
+    item->next = bucket;
+    bucket = item;
+
+    m_cache_pixmaps[item->pixmap] = item;
+    m_cache_stats.entries++;
+    m_cache_stats.bytes += item->size;
+}
+
+void ImageControl::eraseCache(Cache *item) {
+
+    Cache **link = &m_cache_buckets[item->hash % m_cache_buckets.size()];
+    while (*link != item)
+        link = &(*link)->next;
+    *link = item->next;
+
+    if (item->count == 0)
+        m_cache_unused.erase(item->unused_it);
+
+    m_cache_pixmaps.erase(item->pixmap);
+    m_cache_stats.entries--;
+    m_cache_stats.bytes -= item->size;
+
+    FbDrawable::drawableDestroyed(item->pixmap);
+    XFreePixmap(FbTk::App::instance()->display(), item->pixmap);
+    delete item;
+}
+
+void ImageControl::rehashCache(size_t nr_buckets) {
+
+    std::vector<Cache *> buckets(nr_buckets, static_cast<Cache *>(0));
+
+    for (size_t i = 0; i < m_cache_buckets.size(); ++i) {
+        Cache *item = m_cache_buckets[i];
+        while (item) {
+            Cache *next = item->next;
+            Cache *&bucket = buckets[item->hash % nr_buckets];
+            item->next = bucket;
+            bucket = item;
+            item = next;
+        }
     }
 
+    m_cache_buckets.swap(buckets);
 }
 
 void ImageControl::createColorTable() {
@@ -32,6 +32,7 @@
 #include <X11/Xlib.h> // for Visual* etc
 
 #include <list>
+#include <map>
 #include <vector>
 
 namespace FbTk {
@@ -41,6 +42,19 @@ class Texture;
 /// Holds screen info, color tables and caches textures
 class ImageControl: private NotCopyable {
 public:
+    /// counters of the texture cache
+    struct CacheStats {
+        unsigned long hits;      ///< renderImage calls served from the cache
+        unsigned long misses;    ///< renderImage calls that had to render
+        unsigned long evictions; ///< unused pixmaps freed to stay within cache_max
+        unsigned long entries;   ///< number of cached pixmaps
+        unsigned long bytes;     ///< estimated server memory of cached pixmaps
+    };
+
+    /**
+       @param cache_timeout how often (in ms) unused pixmaps are flushed
+       @param cache_max how much pixmap memory (in kB) the cache may hold
+    */
     ImageControl(int screen_num, int colors_per_channel = 4,
                   unsigned long cache_timeout = 300000l, unsigned long cache_max = 200l);
     virtual ~ImageControl();
@@ -73,13 +87,42 @@ public:
     void getGradientBuffers(unsigned int, unsigned int,
                             unsigned int **, unsigned int **);
 
+    /**
+       Create an image to upload rendered textures. Big images are placed
+       in shared memory if the MIT-SHM extension is usable.
+       @return the image or 0 on failure
+    */
+    XImage *createImage(unsigned int width, unsigned int height);
+    /// upload an image created by createImage() to 'drawable' and destroy it
+    void putImage(Drawable drawable, XImage *image);
+    /// destroy an image created by createImage() without uploading it
+    void destroyImage(XImage *image);
+
+    /// free all cached pixmaps which are not in use anymore
     void cleanCache();
+
+    const CacheStats &cacheStats() const { return m_cache_stats; }
+
 private:
+    struct Cache;
+    struct ShmSegment;
+
     /** 
         Search cache for a specific pixmap
         @return None if no cache was found
     */
-    Pixmap searchCache(unsigned int width, unsigned int height, const Texture &text, Orientation orient) const;
+    Pixmap searchCache(unsigned int width, unsigned int height, const Texture &text, Orientation orient);
+
+    void insertCache(Cache *item);
+    void eraseCache(Cache *item);
+    /// free least recently used, unused pixmaps until the cache fits into cache_max
+    void trimCache();
+    void rehashCache(size_t nr_buckets);
+
+    /// a shared memory segment of at least 'size' bytes, 0 if MIT-SHM is not usable
+    ShmSegment *acquireShmSegment(size_t size);
+    ShmSegment *createShmSegment(size_t size);
+    void destroyShmSegment(ShmSegment *segment);
 
     void createColorTable();
     Timer m_timer;
@@ -105,11 +148,17 @@ private:
     std::vector<unsigned int> grad_xbuffer;
     std::vector<unsigned int> grad_ybuffer;
 
-    struct Cache;
     typedef std::list<Cache *> CacheList;
+    typedef std::map<Pixmap, Cache *> PixmapCacheMap;
+
+    std::vector<Cache *> m_cache_buckets; ///< hash index, chained through Cache::next
+    PixmapCacheMap m_cache_pixmaps; ///< rendered pixmap -> cache item
+    CacheList m_cache_unused; ///< unused cache items, least recently used first
+    unsigned long m_cache_max; ///< max bytes of cached pixmaps
+    CacheStats m_cache_stats;
 
-    mutable CacheList cache;
-    unsigned long cache_max;
+    bool m_shm_usable; ///< MIT-SHM extension is available and works
+    std::vector<ShmSegment *> m_shm_segments; ///< reusable shared memory segments
 };
 
 } // end namespace FbTk
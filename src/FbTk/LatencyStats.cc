@@ -0,0 +1,197 @@
+// LatencyStats.cc for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "LatencyStats.hh"
+#include "StringUtil.hh"
+
+#include <X11/X.h>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif // __GNUC__
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+typedef std::map<std::string, FbTk::LatencyHistogram> Histograms;
+
+Histograms s_histograms;
+
+typedef std::pair<std::string, const FbTk::LatencyHistogram *> Entry;
+
+bool moreTotal(const Entry &a, const Entry &b) {
+    return a.second->total() > b.second->total();
+}
+
+/// "FbTk::SlotImpl<Functor, void, ...>" -> "Functor", the functor tells more
+std::string stripSlot(const std::string &name) {
+
+    const std::string slot = "FbTk::SlotImpl<";
+    if (name.compare(0, slot.size(), slot) != 0)
+        return name;
+
+    int depth = 0;
+    for (size_t i = slot.size(); i < name.size(); ++i) {
+        if (name[i] == '<')
+            depth++;
+        else if (name[i] == '>')
+            depth--;
+        else if (name[i] == ',' && depth == 0)
+            return name.substr(slot.size(), i - slot.size());
+    }
+    return name;
+}
+
+// indexed by event type, see X11/X.h
+const char *s_event_names[] = {
+    0, 0,
+    "KeyPress", "KeyRelease", "ButtonPress", "ButtonRelease",
+    "MotionNotify", "EnterNotify", "LeaveNotify", "FocusIn", "FocusOut",
+    "KeymapNotify", "Expose", "GraphicsExpose", "NoExpose",
+    "VisibilityNotify", "CreateNotify", "DestroyNotify", "UnmapNotify",
+    "MapNotify", "MapRequest", "ReparentNotify", "ConfigureNotify",
+    "ConfigureRequest", "GravityNotify", "ResizeRequest",
+    "CirculateNotify", "CirculateRequest", "PropertyNotify",
+    "SelectionClear", "SelectionRequest", "SelectionNotify",
+    "ColormapNotify", "ClientMessage", "MappingNotify", "GenericEvent"
+};
+
+}
+
+namespace FbTk {
+
+bool LatencyStats::s_enabled = false;
+
+LatencyHistogram::LatencyHistogram():
+    m_count(0),
+    m_total(0),
+    m_max(0) {
+
+    std::fill(m_buckets, m_buckets + NR_BUCKETS, 0);
+}
+
+void LatencyHistogram::add(uint64_t usec) {
+
+    size_t i = 0;
+    while (i < NR_BUCKETS - 1 && (static_cast<uint64_t>(1) << i) <= usec)
+        ++i;
+
+    m_buckets[i]++;
+    m_count++;
+    m_total += usec;
+    m_max = std::max(m_max, usec);
+}
+
+uint64_t LatencyHistogram::percentile(unsigned int percent) const {
+
+    // the rank of the percentile, rounded up
+    unsigned long rank = (static_cast<uint64_t>(m_count) * percent + 99) / 100;
+    unsigned long seen = 0;
+    for (size_t i = 0; i < NR_BUCKETS - 1; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank && seen > 0)
+            return static_cast<uint64_t>(1) << i;
+    }
+    return m_max;
+}
+
+void LatencyStats::setEnabled(bool enabled) {
+    s_enabled = enabled;
+}
+
+void LatencyStats::add(const std::string &name, uint64_t start) {
+    uint64_t now = FbTime::mono();
+    s_histograms[name].add(now > start ? now - start : 0);
+}
+
+void LatencyStats::reset() {
+    s_histograms.clear();
+}
+
+std::string LatencyStats::report() {
+
+    std::vector<Entry> entries;
+    Histograms::const_iterator it = s_histograms.begin();
+    for (; it != s_histograms.end(); ++it)
+        entries.push_back(Entry(it->first, &it->second));
+
+    std::sort(entries.begin(), entries.end(), moreTotal);
+
+    std::ostringstream out;
+    out << "latency stats " << (s_enabled ? "on" : "off")
+        << ", times in usec, bucket <N counts durations below N\n";
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const LatencyHistogram &h = *entries[i].second;
+        out << entries[i].first << ": count " << h.count()
+            << " total " << h.total()
+            << " avg " << (h.count() ? h.total() / h.count() : 0)
+            << " p50 <" << h.percentile(50)
+            << " p99 <" << h.percentile(99)
+            << " max " << h.max() << "\n ";
+
+        for (size_t b = 0; b < LatencyHistogram::NR_BUCKETS; ++b) {
+            if (h.bucket(b) == 0)
+                continue;
+            if (b < LatencyHistogram::NR_BUCKETS - 1)
+                out << " <" << (static_cast<uint64_t>(1) << b);
+            else
+                out << " >=" << (static_cast<uint64_t>(1) << (b - 1));
+            out << ":" << h.bucket(b);
+        }
+        out << "\n";
+    }
+
+    return out.str();
+}
+
+std::string LatencyStats::eventName(int type) {
+
+    const int nr_names = sizeof(s_event_names) / sizeof(s_event_names[0]);
+    if (type >= 0 && type < nr_names && s_event_names[type])
+        return s_event_names[type];
+
+    // events of extensions like shape or randr
+    return "type" + StringUtil::number2String(type);
+}
+
+std::string LatencyStats::typeName(const std::type_info &type) {
+
+#ifdef __GNUC__
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(type.name(), 0, 0, &status);
+    if (status == 0 && demangled) {
+        std::string name(demangled);
+        free(demangled);
+        return stripSlot(name);
+    }
+    free(demangled);
+#endif // __GNUC__
+
+    return type.name();
+}
+
+} // end namespace FbTk
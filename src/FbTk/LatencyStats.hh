@@ -0,0 +1,86 @@
+// LatencyStats.hh for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_LATENCYSTATS_HH
+#define FBTK_LATENCYSTATS_HH
+
+#include "FbTime.hh"
+
+#include <string>
+#include <typeinfo>
+
+namespace FbTk {
+
+/// counts durations in buckets of powers of two microseconds
+class LatencyHistogram {
+public:
+    /// bucket i counts durations below 2^i usec, the last one all longer ones
+    enum { NR_BUCKETS = 24 };
+
+    LatencyHistogram();
+
+    void add(uint64_t usec);
+
+    unsigned long count() const { return m_count; }
+    uint64_t total() const { return m_total; }
+    uint64_t max() const { return m_max; }
+    unsigned long bucket(size_t i) const { return m_buckets[i]; }
+
+    /// @return upper bound (in usec) of the bucket holding the given percentile
+    uint64_t percentile(unsigned int percent) const;
+
+private:
+    unsigned long m_buckets[NR_BUCKETS];
+    unsigned long m_count;
+    uint64_t m_total;
+    uint64_t m_max;
+};
+
+/**
+   Collects how long the handlers of X events, timers and the like take,
+   one LatencyHistogram per name. Disabled by default; callers check
+   enabled() before taking the time, so it costs a branch when off.
+*/
+class LatencyStats {
+public:
+    static bool enabled() { return s_enabled; }
+    static void setEnabled(bool enabled);
+
+    /// adds the time since start (see FbTime::mono()) to the histogram of name
+    static void add(const std::string &name, uint64_t start);
+    static void reset();
+
+    /// @return one line per name, most total time first, with its buckets
+    static std::string report();
+
+    /// @return name of the X event type, e.g. "MotionNotify"
+    static std::string eventName(int type);
+    /// @return readable name of a type, e.g. the class of an event handler
+    /// or the functor of a Slot
+    static std::string typeName(const std::type_info &type);
+
+private:
+    static bool s_enabled;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_LATENCYSTATS_HH
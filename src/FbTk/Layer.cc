@@ -74,32 +74,11 @@ void extract_windows_to_stack(const FbTk::Layer::ItemList& items, LayerItem* tem
     }
 }
 
-void restack(const FbTk::Layer::ItemList& items, LayerItem* temp_raised) {
-
-    std::vector<Window> stack;
-    extract_windows_to_stack(items, temp_raised, stack);
-
-    if (!stack.empty())
-        XRestackWindows(FbTk::App::instance()->display(), &stack[0], stack.size());
-}
-
 } // end of anonymous namespace
 
 
-void Layer::restack(const std::vector<Layer*>& layers) {
-
-    std::vector<Window> stack;
-    std::vector<Layer*>::const_iterator l;
-    for (l = layers.begin(); l != layers.end(); ++l) {
-        extract_windows_to_stack((*l)->itemList(), 0, stack);
-    }
-
-    if (!stack.empty())
-        XRestackWindows(FbTk::App::instance()->display(), &stack[0], stack.size());
-}
-
 Layer::Layer(MultLayers &manager, int layernum):
-    m_manager(manager), m_layernum(layernum), m_needs_restack(false) {
+    m_manager(manager), m_layernum(layernum), m_temp_raised(0) {
 }
 
 Layer::~Layer() {
@@ -107,14 +86,17 @@ Layer::~Layer() {
 }
 
 void Layer::restack() {
-    if (m_manager.isUpdatable()) {
-        ::restack(itemList(), 0);
-        m_needs_restack = false;
-    }
+    // any restack reverts a temporary raise
+    m_temp_raised = 0;
+    m_manager.restack();
 }
 
-void Layer::restackAndTempRaise(LayerItem &item) {
-    ::restack(itemList(), &item);
+void Layer::stackWindows(std::vector<Window> &stack) const {
+    extract_windows_to_stack(itemList(), m_temp_raised, stack);
+}
+
+void Layer::forgetWindow(Window win) {
+    m_manager.forgetWindow(win);
 }
 
 int Layer::countWindows() {
@@ -124,58 +106,19 @@ int Layer::countWindows() {
 
 // Stack all windows associated with 'item' below the 'above' item
 void Layer::stackBelowItem(LayerItem &item, LayerItem *above) {
-    if (!m_manager.isUpdatable())
-        return;
-
-    // if there are no windows provided for above us,
-    // then we must restack the entire layer
-    // we can't do XRaiseWindow because a restack then causes OverrideRedirect
-    // windows to get pushed to the bottom
-    if (!above || m_needs_restack) { // must need to go right to top
-        restack();
-        return;
-    }
-
-    std::vector<Window> stack;
-
-    // We do have a window to stack below
-    // so we put it on top, and fill the rest of the array with the ones to go below it.
-    // assume that above's window exists
-    stack.push_back(above->getWindows().back()->window());
-
-    // fill the rest of the array
-    extract_windows_to_stack(item.getWindows(), stack);
-
-    XRestackWindows(FbTk::App::instance()->display(), &stack[0], stack.size());
-}
-
-// We can't just use Restack here, because it won't do anything if they're
-// already in the same relative order excluding other windows
-void Layer::alignItem(LayerItem &item) {
-    if (itemList().front() == &item) {
-        stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-        return;
+    if (above && above != &item && &above->getLayer() == this) {
+        iterator it = std::find(itemList().begin(), itemList().end(), &item);
+        if (it != itemList().end()) {
+            itemList().erase(it);
+            it = std::find(itemList().begin(), itemList().end(), above);
+            if (it != itemList().end())
+                ++it;
+            itemList().insert(it, &item);
+            m_manager.stackingChanged();
+        }
     }
 
-    // Note: some other things effectively assume that the window list is
-    // sorted from highest to lowest
-    // get our item
-    iterator myit = std::find(itemList().begin(), itemList().end(), &item);
-    iterator it = myit;
-
-    // go to the one above it in our layer (top is front, so we decrement)
-    --it;
-
-    // keep going until we find one that is currently visible to the user
-    while (it != itemList().begin() && !(*it)->visible())
-        --it;
-
-    if (it == itemList().begin() && !(*it)->visible())
-        // reached front item, but it wasn't visible, therefore it was already raised
-        stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-    else
-        stackBelowItem(item, *it);
-
+    restack();
 }
 
 Layer::iterator Layer::insert(LayerItem &item, unsigned int pos) {
@@ -186,8 +129,8 @@ Layer::iterator Layer::insert(LayerItem &item, unsigned int pos) {
 #endif // DEBUG
 
     itemList().push_front(&item);
-    // restack below next window up
-    stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
+    restack();
+    m_manager.stackingChanged();
     return itemList().begin();
 }
 
@@ -197,6 +140,13 @@ void Layer::remove(LayerItem &item) {
     for (; it != it_end; ++it) {
         if (*it == &item) {
             itemList().erase(it);
+            if (m_temp_raised == &item)
+                m_temp_raised = 0;
+            // the windows might get reused, destroyed or reparented
+            LayerItem::Windows::const_iterator win = item.getWindows().begin();
+            for (; win != item.getWindows().end(); ++win)
+                forgetWindow((*win)->window());
+            m_manager.stackingChanged();
             break;
         }
     }
@@ -206,7 +156,7 @@ void Layer::raise(LayerItem &item) {
     // assume it is already in this layer
 
     if (&item == itemList().front()) {
-        if (m_needs_restack)
+        if (m_temp_raised)
             restack();
         return; // nothing to do
     }
@@ -223,14 +173,14 @@ void Layer::raise(LayerItem &item) {
     }
 
     itemList().push_front(&item);
-    stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-
+    restack();
+    m_manager.stackingChanged();
 }
 
 void Layer::tempRaise(LayerItem &item) {
     // assume it is already in this layer
 
-    if (!m_needs_restack && &item == itemList().front())
+    if (!m_temp_raised && &item == itemList().front())
         return; // nothing to do
 
     iterator it = std::find(itemList().begin(), itemList().end(), &item);
@@ -241,12 +191,8 @@ void Layer::tempRaise(LayerItem &item) {
         return;
     }
 
-    if (m_needs_restack)
-        restackAndTempRaise(item);
-    else
-        stackBelowItem(item, m_manager.getLowestItemAboveLayer(m_layernum));
-
-    m_needs_restack = true;
+    m_temp_raised = &item;
+    m_manager.restack();
 }
 
 void Layer::lower(LayerItem &item) {
@@ -254,7 +200,7 @@ void Layer::lower(LayerItem &item) {
 
     // is it already the lowest?
     if (&item == itemList().back()) {
-        if (m_needs_restack)
+        if (m_temp_raised)
             restack();
         return; // nothing to do
     }
@@ -272,20 +218,8 @@ void Layer::lower(LayerItem &item) {
 
     // add it to the bottom
     itemList().push_back(&item);
-
-    // find the item we need to stack below
-    // start at the end
-    it = itemList().end();
-
-    // go up one so we have an object (which must exist, since at least this item is in the layer)
-    it--;
-
-    // go down another one
-    // must exist, otherwise our item must == itemList().back()
-    it--;
-
-    // and restack our window below that one.
-    stackBelowItem(item, *it);
+    restack();
+    m_manager.stackingChanged();
 }
 
 void Layer::raiseLayer(LayerItem &item) {
@@ -23,6 +23,8 @@
 #ifndef FBTK_LAYER_HH
 #define FBTK_LAYER_HH
 
+#include <X11/Xlib.h>
+
 #include <vector>
 #include <list>
 
@@ -44,8 +46,6 @@ public:
 
     void setLayerNum(int layernum) { m_layernum = layernum; };
     int  getLayerNum() const { return m_layernum; };
-    // Put all items on the same layer (called when layer item added to)
-    void alignItem(LayerItem &item);
     int countWindows();
     void stackBelowItem(LayerItem &item, LayerItem *above);
     LayerItem *getLowestItem();
@@ -68,15 +68,17 @@ public:
     void lowerLayer(LayerItem &item);
     void moveToLayer(LayerItem &item, int layernum);
 
-    static void restack(const std::vector<Layer*>& layers);
-
-private:
+    /// appends the windows of the layer, top first, to stack
+    void stackWindows(std::vector<Window> &stack) const;
+    /// the stacking of win on the server is not known any more
+    void forgetWindow(Window win);
+    /// brings the windows on the server in line, e.g. after one was added
     void restack();
-    void restackAndTempRaise(LayerItem &item);
 
+private:
     MultLayers &m_manager;
     int m_layernum;
-    bool m_needs_restack;
+    LayerItem *m_temp_raised; ///< item on top until the next restack
     ItemList m_items;
 };
 
@@ -22,6 +22,7 @@
 
 #include "LayerItem.hh"
 #include "Layer.hh"
+#include "FbWindow.hh"
 
 #include <algorithm>
 
@@ -76,7 +77,7 @@ void LayerItem::addWindow(FbWindow &win) {
     // I'd like to think we can trust ourselves that it won't be added twice...
     // Otherwise we're always scanning through the list.
     m_windows.push_back(&win);
-    m_layer->alignItem(*this);
+    m_layer->restack();
 }
 
 void LayerItem::removeWindow(FbWindow &win) {
@@ -84,8 +85,10 @@ void LayerItem::removeWindow(FbWindow &win) {
     // Otherwise we're always scanning through the list.
 
     LayerItem::Windows::iterator it = std::find(m_windows.begin(), m_windows.end(), &win);
-    if (it != m_windows.end())
+    if (it != m_windows.end()) {
         m_windows.erase(it);
+        m_layer->forgetWindow(win.window());
+    }
 }
 
 void LayerItem::bringToTop(FbWindow &win) {
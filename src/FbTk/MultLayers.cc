@@ -28,8 +28,56 @@
 
 #include "Util.hh"
 
+#include <algorithm>
+#include <map>
+
 using namespace FbTk;
 
+namespace {
+
+const size_t NONE = static_cast<size_t>(-1);
+
+/**
+ * Marks the longest increasing subsequence of order in keep: the largest
+ * set of windows which already are in the right order relative to each
+ * other, so they can stay where they are.
+ */
+void keepLongestRun(const std::vector<size_t> &order, std::vector<bool> &keep) {
+
+    // tails[n] is the index of the smallest last position of any
+    // increasing run of length n+1 found so far
+    std::vector<size_t> tails;
+    std::vector<size_t> prev(order.size(), NONE);
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t low = 0, high = tails.size();
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            if (order[tails[mid]] < order[i])
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (low > 0)
+            prev[i] = tails[low - 1];
+        if (low == tails.size())
+            tails.push_back(i);
+        else
+            tails[low] = i;
+    }
+
+    for (size_t i = tails.empty() ? NONE : tails.back(); i != NONE; i = prev[i])
+        keep[order[i]] = true;
+}
+
+void stackWindow(Display *disp, Window win, Window sibling, int mode) {
+    XWindowChanges changes;
+    changes.sibling = sibling;
+    changes.stack_mode = mode;
+    XConfigureWindow(disp, win, CWSibling | CWStackMode, &changes);
+}
+
+} // end of anonymous namespace
+
 MultLayers::MultLayers(int numlayers) :
     m_lock(0)
 {
@@ -60,7 +108,6 @@ LayerItem *MultLayers::getLowestItemAboveLayer(int layernum) {
 void MultLayers::addToTop(LayerItem &item, int layernum) {
     layernum = FbTk::Util::clamp(layernum, 0, static_cast<signed>(m_layers.size()) - 1);
     m_layers[layernum]->insert(item);
-    restack();
 }
 
 
@@ -114,7 +161,70 @@ void MultLayers::restack() {
     if (!isUpdatable())
         return;
 
-    Layer::restack(m_layers);
+    std::vector<Window> stack;
+    for (size_t i = 0; i < m_layers.size(); ++i)
+        m_layers[i]->stackWindows(stack);
+
+    std::vector<StackMove> moves;
+    planRestack(m_stack, stack, moves);
+
+    Display *disp = App::instance()->display();
+    for (size_t i = 0; i < moves.size(); ++i)
+        stackWindow(disp, moves[i].win, moves[i].sibling, moves[i].mode);
+
+    m_stack.swap(stack);
+}
+
+void MultLayers::planRestack(const std::vector<Window> &last,
+                             const std::vector<Window> &stack,
+                             std::vector<StackMove> &moves) {
+
+    // the new positions of the windows in the order they were sent last
+    std::map<Window, size_t> position;
+    for (size_t i = 0; i < stack.size(); ++i)
+        position.insert(std::make_pair(stack[i], i));
+
+    std::vector<size_t> order;
+    order.reserve(last.size());
+    std::vector<Window>::const_iterator it = last.begin();
+    for (; it != last.end(); ++it) {
+        std::map<Window, size_t>::const_iterator pos = position.find(*it);
+        if (pos != position.end())
+            order.push_back(pos->second);
+    }
+
+    std::vector<bool> keep(stack.size(), false);
+    keepLongestRun(order, keep);
+
+    // nothing is known, so restack around the top window like
+    // XRestackWindows would
+    size_t first = std::find(keep.begin(), keep.end(), true) - keep.begin();
+    if (first == stack.size() && !stack.empty()) {
+        first = 0;
+        keep[0] = true;
+    }
+
+    // windows above the first one that stays go on top of it, every
+    // other window that moved goes right below the one above it
+    StackMove move;
+    for (size_t i = first; i-- > 0; ) {
+        move.win = stack[i];
+        move.sibling = stack[i + 1];
+        move.mode = Above;
+        moves.push_back(move);
+    }
+    for (size_t i = first + 1; i < stack.size(); ++i) {
+        if (!keep[i]) {
+            move.win = stack[i];
+            move.sibling = stack[i - 1];
+            move.mode = Below;
+            moves.push_back(move);
+        }
+    }
+}
+
+void MultLayers::forgetWindow(Window win) {
+    m_stack.erase(std::remove(m_stack.begin(), m_stack.end(), win), m_stack.end());
 }
 
 int MultLayers::size() {
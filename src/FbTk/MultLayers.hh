@@ -23,6 +23,10 @@
 #ifndef FBTK_MULTLAYERS_HH
 #define FBTK_MULTLAYERS_HH
 
+#include "Signal.hh"
+
+#include <X11/Xlib.h>
+
 #include <vector>
 #include <cstdlib> // size_t
 
@@ -59,13 +63,41 @@ public:
 
     bool isUpdatable() const { return m_lock == 0; }
     void lock() { ++m_lock; }
-    void unlock() { if (--m_lock == 0) restack(); }
+    void unlock() { if (--m_lock == 0) { restack(); stackingChanged(); } }
 
-private:
+    /**
+     * Brings the stacking order on the server in line with the layers.
+     * Only the windows which moved since the last restack get restacked.
+     */
     void restack();
+    /// the stacking of win on the server is not known any more
+    void forgetWindow(Window win);
 
+    /// one XConfigureWindow of a restack
+    struct StackMove {
+        Window win;
+        Window sibling;
+        int mode; ///< Above or Below sibling
+    };
+    /**
+     * Computes the moves which turn the stacking order last into stack
+     * (both top first). The longest run of windows which already are in
+     * the right order relative to each other stays where it is.
+     */
+    static void planRestack(const std::vector<Window> &last,
+                            const std::vector<Window> &stack,
+                            std::vector<StackMove> &moves);
+
+    /// emitted after the stacking order of the items changed
+    Signal<> &restackSig() { return m_restack_sig; }
+    /// called by the layers when the order of their items changed
+    void stackingChanged() { if (isUpdatable()) m_restack_sig.emit(); }
+
+private:
     std::vector<Layer *> m_layers;
+    std::vector<Window> m_stack; ///< the stacking order last sent, top first
     int m_lock;
+    Signal<> m_restack_sig;
 };
 
 }
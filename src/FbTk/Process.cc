@@ -0,0 +1,106 @@
+// Process.cc for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "Process.hh"
+
+#if defined(HAVE_SPAWN_H) && defined(HAVE_POSIX_SPAWN)
+  #include <spawn.h>
+#endif
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+extern char **environ;
+
+namespace FbTk {
+
+namespace Process {
+
+namespace {
+
+// our environment, with the entries of env put in place of the ones
+// named the same
+void buildEnvironment(const std::vector<std::string> &env,
+                      std::vector<char *> &envp) {
+    for (char **var = environ; var != 0 && *var != 0; ++var) {
+        size_t i = 0;
+        for (; i < env.size(); ++i) {
+            size_t name_len = env[i].find('=');
+            if (name_len != std::string::npos &&
+                strncmp(*var, env[i].c_str(), name_len + 1) == 0)
+                break;
+        }
+        if (i == env.size())
+            envp.push_back(*var);
+    }
+    for (size_t i = 0; i < env.size(); ++i)
+        envp.push_back(const_cast<char *>(env[i].c_str()));
+    envp.push_back(0);
+}
+
+} // end anonymous namespace
+
+pid_t spawnShell(const std::string &command,
+                 const std::vector<std::string> &env) {
+
+    const char *shell = getenv("SHELL");
+    if (!shell)
+        shell = "/bin/sh";
+
+    char *argv[] = {
+        const_cast<char *>(shell),
+        const_cast<char *>("-c"),
+        const_cast<char *>(command.c_str()),
+        0
+    };
+    std::vector<char *> envp;
+    buildEnvironment(env, envp);
+
+#if defined(HAVE_SPAWN_H) && defined(HAVE_POSIX_SPAWN) && defined(POSIX_SPAWN_SETSID)
+    // the child borrows our memory until it execs instead of getting a
+    // copy of the page tables of a big process, which fork has to make
+    // while we wait
+    posix_spawnattr_t attr;
+    if (posix_spawnattr_init(&attr) != 0)
+        return -1;
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+
+    pid_t pid = -1;
+    int error = posix_spawn(&pid, shell, 0, &attr, argv, &envp[0]);
+    posix_spawnattr_destroy(&attr);
+    return error == 0 ? pid : -1;
+#else
+    pid_t pid = fork();
+    if (pid)
+        return pid;
+
+    // this process exits immediately, so we don't have to worry about memleaks
+    setsid();
+    execve(shell, argv, &envp[0]);
+    // no exit(), the destructors and atexit handlers belong to the parent
+    _exit(127);
+#endif
+}
+
+} // end namespace Process
+
+} // end namespace FbTk
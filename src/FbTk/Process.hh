@@ -0,0 +1,48 @@
+// Process.hh for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_PROCESS_HH
+#define FBTK_PROCESS_HH
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+namespace FbTk {
+
+/// Starting other programs
+
+namespace Process {
+
+    /**
+       Runs command with $SHELL -c (or /bin/sh) in a session of its own.
+       @param env "NAME=value" entries replacing or adding to our environment
+       @return pid of the child, -1 if it couldn't be started
+    */
+    pid_t spawnShell(const std::string &command,
+                     const std::vector<std::string> &env);
+
+} // end namespace Process
+
+} // end namespace FbTk
+
+#endif // FBTK_PROCESS_HH
@@ -0,0 +1,222 @@
+// PropertySnapshot.cc for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "PropertySnapshot.hh"
+
+#ifdef HAVE_XCB
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+#include <vector>
+#endif // HAVE_XCB
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace FbTk {
+
+namespace {
+
+// in 32 bit units, as for XGetWindowProperty: everything there is
+const long MAX_LENGTH = 0x7fffffff;
+
+size_t itemSize(int format) {
+    switch (format) {
+    case 16:
+        return sizeof(short);
+    case 32:
+        return sizeof(long);
+    }
+    return 1;
+}
+
+} // end anonymous namespace
+
+PropertySnapshot::PropertySnapshot(Display *display, Window win):
+    m_display(display), m_window(win) {
+}
+
+PropertySnapshot::~PropertySnapshot() {
+    for (Values::iterator it = m_values.begin(); it != m_values.end(); ++it) {
+        if (it->second.data != 0)
+            XFree(it->second.data);
+    }
+}
+
+void PropertySnapshot::fetch(const Atom *props, size_t count) {
+#ifdef HAVE_XCB
+    fetchPipelined(props, count);
+#else
+    fetchEach(props, count);
+#endif // HAVE_XCB
+}
+
+void PropertySnapshot::fetchEach(const Atom *props, size_t count) {
+    int nr_present = 0;
+    Atom *present = XListProperties(m_display, m_window, &nr_present);
+    // nothing there or the window is gone, either way the server knows
+    if (present == 0)
+        return;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_values.find(props[i]) != m_values.end())
+            continue;
+
+        Value value;
+        if (std::find(present, present + nr_present, props[i]) != present + nr_present &&
+            XGetWindowProperty(m_display, m_window, props[i], 0, MAX_LENGTH, False,
+                               AnyPropertyType, &value.type, &value.format,
+                               &value.nitems, &value.bytes_after,
+                               &value.data) != Success)
+            continue;
+
+        m_values[props[i]] = value;
+    }
+
+    XFree(present);
+}
+
+#ifdef HAVE_XCB
+void PropertySnapshot::fetchPipelined(const Atom *props, size_t count) {
+    xcb_connection_t *conn = XGetXCBConnection(m_display);
+    std::vector<Atom> asked;
+    std::vector<xcb_get_property_cookie_t> cookies;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_values.find(props[i]) != m_values.end() ||
+            std::find(asked.begin(), asked.end(), props[i]) != asked.end())
+            continue;
+        asked.push_back(props[i]);
+        cookies.push_back(xcb_get_property(conn, 0, m_window, props[i],
+                                           XCB_GET_PROPERTY_TYPE_ANY,
+                                           0, MAX_LENGTH));
+    }
+
+    for (size_t i = 0; i < cookies.size(); ++i) {
+        xcb_generic_error_t *error = 0;
+        xcb_get_property_reply_t *reply =
+            xcb_get_property_reply(conn, cookies[i], &error);
+        if (reply == 0) {
+            free(error);
+            continue;
+        }
+
+        Value value;
+        value.type = reply->type;
+        value.format = reply->format;
+        value.bytes_after = reply->bytes_after;
+        if (value.type != None) {
+            // Xlib hands out 16 and 32 bit items as shorts and longs,
+            // sign extended
+            value.nitems = reply->value_len;
+            size_t size = itemSize(value.format);
+            value.data = static_cast<unsigned char *>(malloc(value.nitems * size + 1));
+            if (value.data == 0) {
+                free(reply);
+                continue;
+            }
+
+            const void *raw = xcb_get_property_value(reply);
+            for (unsigned long item = 0; item < value.nitems; ++item) {
+                switch (value.format) {
+                case 16:
+                    reinterpret_cast<short *>(value.data)[item] =
+                        static_cast<const int16_t *>(raw)[item];
+                    break;
+                case 32:
+                    reinterpret_cast<long *>(value.data)[item] =
+                        static_cast<const int32_t *>(raw)[item];
+                    break;
+                default:
+                    value.data[item] = static_cast<const uint8_t *>(raw)[item];
+                    break;
+                }
+            }
+            value.data[value.nitems * size] = 0;
+        }
+        free(reply);
+
+        m_values[asked[i]] = value;
+    }
+}
+#endif // HAVE_XCB
+
+bool PropertySnapshot::get(Atom prop, long long_length, Atom req_type,
+                           Atom *actual_type_return, int *actual_format_return,
+                           unsigned long *nitems_return,
+                           unsigned long *bytes_after_return,
+                           unsigned char **prop_return) const {
+    Values::const_iterator it = m_values.find(prop);
+    if (it == m_values.end())
+        return false;
+
+    const Value &value = it->second;
+    if (value.type == None) {
+        *actual_type_return = None;
+        *actual_format_return = 0;
+        *nitems_return = 0;
+        *bytes_after_return = 0;
+        *prop_return = 0;
+        return true;
+    }
+
+    // the server counts in bytes, 4 of them per requested long
+    unsigned long bytes = value.nitems * (value.format / 8);
+    unsigned long total = bytes + value.bytes_after;
+    unsigned long wanted = 0;
+    if (req_type == AnyPropertyType || req_type == value.type) {
+        wanted = total;
+        if (long_length <= 0)
+            wanted = 0;
+        else if (static_cast<unsigned long>(long_length) < total / 4 + 1)
+            wanted = 4 * static_cast<unsigned long>(long_length);
+        // asks for more than was read
+        if (wanted > bytes)
+            return false;
+    }
+
+    // as Xlib does, the data is there and terminated even when empty
+    unsigned long nitems = wanted / (value.format / 8);
+    size_t size = itemSize(value.format);
+    unsigned char *data = static_cast<unsigned char *>(malloc(nitems * size + 1));
+    if (data == 0)
+        return false;
+    memcpy(data, value.data, nitems * size);
+    data[nitems * size] = 0;
+
+    *actual_type_return = value.type;
+    *actual_format_return = value.format;
+    *nitems_return = nitems;
+    *bytes_after_return = total - wanted;
+    *prop_return = data;
+    return true;
+}
+
+void PropertySnapshot::forget(Atom prop) {
+    Values::iterator it = m_values.find(prop);
+    if (it == m_values.end())
+        return;
+    if (it->second.data != 0)
+        XFree(it->second.data);
+    m_values.erase(it);
+}
+
+} // end namespace FbTk
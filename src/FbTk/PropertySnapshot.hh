@@ -0,0 +1,83 @@
+// PropertySnapshot.hh for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_PROPERTYSNAPSHOT_HH
+#define FBTK_PROPERTYSNAPSHOT_HH
+
+#include <X11/Xlib.h>
+
+#include <map>
+#include <cstdlib> // size_t
+
+namespace FbTk {
+
+/**
+   Properties of one window read in one go. All requests are sent before
+   the first reply is waited for when built with xcb, else the properties
+   the window doesn't have are sorted out with one XListProperties and only
+   the rest is read. The values are handed out the way XGetWindowProperty
+   would, so code reading properties one by one can be served from here.
+*/
+class PropertySnapshot {
+public:
+    PropertySnapshot(Display *display, Window win);
+    ~PropertySnapshot();
+
+    /// reads all props, leaving out those already in the snapshot
+    void fetch(const Atom *props, size_t count);
+
+    /**
+       Works like XGetWindowProperty from offset 0 without deleting,
+       prop_return has to be freed with XFree.
+       @return false if prop isn't in the snapshot or was cut short
+    */
+    bool get(Atom prop, long long_length, Atom req_type,
+             Atom *actual_type_return, int *actual_format_return,
+             unsigned long *nitems_return, unsigned long *bytes_after_return,
+             unsigned char **prop_return) const;
+
+    /// drops prop, so the next get asks the server again
+    void forget(Atom prop);
+
+private:
+    struct Value {
+        Value(): type(None), format(0), nitems(0), bytes_after(0), data(0) { }
+        Atom type;
+        int format;
+        unsigned long nitems; ///< items in data
+        unsigned long bytes_after; ///< bytes left on the server
+        unsigned char *data; ///< like from Xlib, 32 bit items are longs
+    };
+    typedef std::map<Atom, Value> Values;
+
+    void fetchEach(const Atom *props, size_t count);
+#ifdef HAVE_XCB
+    void fetchPipelined(const Atom *props, size_t count);
+#endif // HAVE_XCB
+
+    Display *m_display;
+    Window m_window;
+    Values m_values;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_PROPERTYSNAPSHOT_HH
@@ -0,0 +1,284 @@
+// Reactor.cc for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "Reactor.hh"
+#include "Timer.hh"
+#include "FbTime.hh"
+
+#ifdef HAVE_CSTRING
+#  include <cstring>
+#else
+#  include <string.h>
+#endif
+
+#ifdef HAVE_SYS_SELECT_H
+#  include <sys/select.h>
+#endif
+
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H)
+#  include <sys/epoll.h>
+#  include <sys/timerfd.h>
+#  define USE_EPOLL
+#endif
+
+#include <unistd.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+typedef std::map<int, FbTk::Reactor::Handler *> Handlers;
+
+Handlers s_handlers;
+
+#ifdef USE_EPOLL
+
+int s_epoll_fd = -1;
+int s_timer_fd = -1;
+bool s_timer_armed = false;
+bool s_epoll_failed = false;
+
+/// creates the epoll instance on first use, false if it is not usable
+bool initEpoll() {
+
+    if (s_epoll_fd != -1)
+        return true;
+    if (s_epoll_failed)
+        return false;
+
+    s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (s_epoll_fd != -1)
+        s_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = s_timer_fd;
+
+    if (s_timer_fd == -1 || epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, s_timer_fd, &ev) != 0) {
+        if (s_timer_fd != -1)
+            close(s_timer_fd);
+        if (s_epoll_fd != -1)
+            close(s_epoll_fd);
+        s_timer_fd = s_epoll_fd = -1;
+        s_epoll_failed = true;
+        return false;
+    }
+
+    // descriptors added before the first use
+    Handlers::const_iterator it = s_handlers.begin();
+    for (; it != s_handlers.end(); ++it) {
+        ev.data.fd = it->first;
+        epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, it->first, &ev);
+    }
+
+    return true;
+}
+
+/// arms the timer to expire in usec microseconds, 0 disarms it
+void setTimer(uint64_t usec) {
+
+    if (usec == 0 && !s_timer_armed)
+        return;
+
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = usec / FbTk::FbTime::IN_SECONDS;
+    spec.it_value.tv_nsec = (usec % FbTk::FbTime::IN_SECONDS) * 1000;
+
+    timerfd_settime(s_timer_fd, 0, &spec, 0);
+    s_timer_armed = (usec != 0);
+}
+
+#endif // USE_EPOLL
+
+/// calls the handler of fd, if it was not removed by an earlier handler
+void handle(int fd) {
+    Handlers::iterator it = s_handlers.find(fd);
+    if (it != s_handlers.end())
+        it->second->handleFd(fd);
+}
+
+/// @return true if the timeout expired
+bool waitSelect(uint64_t timeout, bool forever) {
+
+    fd_set rfds;
+    FD_ZERO(&rfds);
+
+    int max_fd = -1;
+    Handlers::const_iterator it = s_handlers.begin();
+    for (; it != s_handlers.end(); ++it) {
+        FD_SET(it->first, &rfds);
+        max_fd = std::max(max_fd, it->first);
+    }
+
+    timeval tm;
+    tm.tv_sec = timeout / FbTk::FbTime::IN_SECONDS;
+    tm.tv_usec = timeout % FbTk::FbTime::IN_SECONDS;
+
+    int ready = select(max_fd + 1, &rfds, 0, 0, forever ? 0 : &tm);
+    if (ready <= 0)
+        return ready == 0;
+
+    // the handlers might add or remove descriptors, so look at a copy
+    std::vector<int> fds;
+    for (it = s_handlers.begin(); it != s_handlers.end(); ++it) {
+        if (FD_ISSET(it->first, &rfds))
+            fds.push_back(it->first);
+    }
+    for (size_t i = 0; i < fds.size(); ++i)
+        handle(fds[i]);
+
+    return false;
+}
+
+#ifdef USE_EPOLL
+
+/// @return true if the timeout expired
+bool waitEpoll(uint64_t timeout, bool forever) {
+
+    // timeouts below a millisecond need the timerfd, epoll_wait() is
+    // only precise to milliseconds
+    int wait_ms = 0;
+    if (forever || timeout > 0) {
+        wait_ms = -1;
+        setTimer(forever ? 0 : timeout);
+    }
+
+    epoll_event events[16];
+    int ready = epoll_wait(s_epoll_fd, events, 16, wait_ms);
+    if (ready < 0)
+        return false;
+    if (ready == 0)
+        return false;
+
+    bool expired = false;
+    for (int i = 0; i < ready; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == s_timer_fd) {
+            uint64_t expirations;
+            if (read(s_timer_fd, &expirations, sizeof(expirations)) > 0)
+                expired = true;
+            s_timer_armed = false;
+        } else {
+            handle(fd);
+        }
+    }
+
+    return expired;
+}
+
+#endif // USE_EPOLL
+
+}
+
+namespace FbTk {
+
+void Reactor::add(int fd, Handler &handler) {
+
+    bool added = s_handlers.insert(Handlers::value_type(fd, &handler)).second;
+    if (!added) {
+        s_handlers[fd] = &handler;
+        return;
+    }
+
+#ifdef USE_EPOLL
+    if (s_epoll_fd != -1) {
+        epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+#endif // USE_EPOLL
+}
+
+void Reactor::remove(int fd) {
+
+    if (s_handlers.erase(fd) == 0)
+        return;
+
+#ifdef USE_EPOLL
+    if (s_epoll_fd != -1) {
+        epoll_event ev; // needed by kernels before 2.6.9
+        epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, fd, &ev);
+    }
+#endif // USE_EPOLL
+}
+
+void Reactor::dispatch(bool block) {
+
+    uint64_t wakeup = 0;
+    uint64_t timeout = 0;
+    bool timing = Timer::nextWakeup(wakeup);
+    bool forever = false;
+
+    if (block) {
+        uint64_t now = FbTime::mono();
+        if (!timing)
+            forever = true;
+        else if (wakeup > now)
+            timeout = wakeup - now;
+    }
+
+    bool expired;
+#ifdef USE_EPOLL
+    if (initEpoll())
+        expired = waitEpoll(timeout, forever);
+    else
+#endif // USE_EPOLL
+        expired = waitSelect(timeout, forever);
+
+    if (!timing)
+        return;
+
+    // the clock might be a bit behind the timeout that just expired
+    uint64_t now = FbTime::mono();
+    if (expired && timeout > 0)
+        now = std::max(now, wakeup);
+
+    Timer::handleTimeouts(now);
+}
+
+const char *Reactor::backend() {
+#ifdef USE_EPOLL
+    if (initEpoll())
+        return "epoll";
+#endif // USE_EPOLL
+    return "select";
+}
+
+void Reactor::shutdown() {
+
+    s_handlers.clear();
+
+#ifdef USE_EPOLL
+    if (s_timer_fd != -1)
+        close(s_timer_fd);
+    if (s_epoll_fd != -1)
+        close(s_epoll_fd);
+    s_timer_fd = s_epoll_fd = -1;
+    s_timer_armed = false;
+#endif // USE_EPOLL
+}
+
+} // end namespace FbTk
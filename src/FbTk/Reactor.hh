@@ -0,0 +1,63 @@
+// Reactor.hh for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_REACTOR_HH
+#define FBTK_REACTOR_HH
+
+namespace FbTk {
+
+/**
+   Waits for the registered file descriptors (the X connection, sockets,
+   pipes ...) and the running Timers at once and dispatches whatever is
+   ready. Uses epoll with a timerfd for the timers where available and
+   falls back to select() otherwise.
+*/
+class Reactor {
+public:
+
+    /// gets told when its file descriptor is ready to read
+    class Handler {
+    public:
+        virtual ~Handler() { }
+        virtual void handleFd(int fd) = 0;
+    };
+
+    /// calls handler when fd is ready to read, replaces an earlier handler
+    static void add(int fd, Handler &handler);
+    static void remove(int fd);
+
+    /**
+       Handles the file descriptors which are ready and the due timers.
+       @param block if true, sleeps until a file descriptor is ready or the
+              next timer is due. nothing sleeps while a timer is overdue.
+    */
+    static void dispatch(bool block);
+
+    /// @return "epoll" or "select"
+    static const char *backend();
+
+    /// closes the epoll and timer descriptors, drops all handlers
+    static void shutdown();
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_REACTOR_HH
@@ -23,8 +23,6 @@
 
 #include "FbWindow.hh"
 #include "App.hh"
-#include "GContext.hh"
-#include "FbPixmap.hh"
 
 #ifdef HAVE_CSTRING
   #include <cstring>
@@ -45,127 +43,170 @@
 #endif // SHAPE
 
 #include <algorithm>
+#include <map>
 #include <vector>
-#include <iostream>
 
 using std::min;
 
 namespace FbTk {
 
 namespace {
-/* rows is an array of 8 bytes, i.e. 8x8 bits */
-Pixmap makePixmap(Display* disp, int screen_nr, Window parent, const unsigned char rows[]) {
-
-    const size_t data_size = 8 * 8;
-    // we use malloc here so we get consistent C alloc/free with XDestroyImage
-    // and no warnings in valgrind :)
-    char *data = (char *)malloc(data_size * sizeof (char));
-    if (data == 0)
-        return 0;
-
-    memset(data, 0xFF, data_size);
-
-    XImage *ximage = XCreateImage(disp,
-                                  DefaultVisual(disp, screen_nr),
-                                  1,
-                                  XYPixmap, 0,
-                                  data,
-                                  8, 8,
-                                  32, 0);
-    if (ximage == 0) {
-        free(data);
-        return 0;
-    }
-
-    XInitImage(ximage);
 
-    for (int y=0; y<8; y++) {
-        for (int x=0; x<8; x++) {
-            XPutPixel(ximage, x, y, (rows[y] & (0x01 << x)) ? 0 : 1); // inverted, it is subtracted
-        }
+// pixels cut off in each of the 8 rows of a top corner, counted from the
+// side; the bottom corners are the same upside down
+const int s_corner_cut[8] = { 6, 3, 2, 1, 1, 1, 0, 0 };
+
+// the cut of the corners in places at row of a box height high
+void rowCut(int row, int height, int places, int &left, int &right) {
+    left = right = 0;
+    if (row < 8) {
+        if (places & Shape::TOPLEFT)
+            left = s_corner_cut[row];
+        if (places & Shape::TOPRIGHT)
+            right = s_corner_cut[row];
+    }
+    int bottom_row = height - 1 - row;
+    if (bottom_row >= 0 && bottom_row < 8) {
+        if (places & Shape::BOTTOMLEFT)
+            left = std::max(left, s_corner_cut[bottom_row]);
+        if (places & Shape::BOTTOMRIGHT)
+            right = std::max(right, s_corner_cut[bottom_row]);
     }
-
-    FbPixmap pm(parent, 8, 8, 1);
-    GContext gc(pm);
-
-    XPutImage(disp, pm.drawable(), gc.gc(), ximage, 0, 0, 0, 0,
-              8, 8);
-
-    XDestroyImage(ximage);
-
-    return pm.release();
 }
 
-struct CornerPixmaps {
-    CornerPixmaps() : do_create(true) { }
-
-    FbPixmap topleft;
-    FbPixmap topright;
-    FbPixmap botleft;
-    FbPixmap botright;
-
-    bool do_create;
-};
+void addRect(std::vector<XRectangle> &rects, int x, int y, int width, int height) {
+    if (width <= 0 || height <= 0)
+        return;
+    XRectangle rect;
+    rect.x = x;
+    rect.y = y;
+    rect.width = width;
+    rect.height = height;
+    rects.push_back(rect);
+}
 
-// unfortunately, we need a separate pixmap per screen
-std::vector<CornerPixmaps> s_corners;
+// the box without area, in bands from top to bottom
+void boxWithout(int x, int y, int width, int height, const XRectangle &area,
+                std::vector<XRectangle> &rects) {
+    int top = std::max<int>(y, area.y);
+    int bottom = std::min<int>(y + height, area.y + area.height);
+    int left = std::max<int>(x, area.x);
+    int right = std::min<int>(x + width, area.x + area.width);
+    if (top >= bottom || left >= right) {
+        addRect(rects, x, y, width, height);
+        return;
+    }
 
-unsigned long nr_shapes = 0;
+    addRect(rects, x, y, width, top - y);
+    addRect(rects, x, top, left - x, bottom - top);
+    addRect(rects, right, top, x + width - right, bottom - top);
+    addRect(rects, x, bottom, width, y + height - bottom);
+}
 
-void initCorners(int screen) {
+// the pixels the rounded corners take away, row by row
+void cornerCuts(int x, int y, int width, int height, int places,
+                std::vector<XRectangle> &rects) {
+    for (int row = 0; row < 8; ++row) {
+        int cut = s_corner_cut[row];
+        if (places & Shape::TOPLEFT)
+            addRect(rects, x, y + row, cut, 1);
+        if (places & Shape::TOPRIGHT)
+            addRect(rects, x + width - cut, y + row, cut, 1);
+        if (places & Shape::BOTTOMLEFT)
+            addRect(rects, x, y + height - 1 - row, cut, 1);
+        if (places & Shape::BOTTOMRIGHT)
+            addRect(rects, x + width - cut, y + height - 1 - row, cut, 1);
+    }
+}
 
-    Display* disp = App::instance()->display();
-    if (s_corners.empty())
-        s_corners.resize(ScreenCount(disp));
+XRectangle *data(std::vector<XRectangle> &rects) {
+    return rects.empty() ? 0 : &rects[0];
+}
 
+} // end of anonymous namespace
 
-    if (screen < 0 || screen > static_cast<int>(s_corners.size())) {
-        std::cerr << "FbTk/Shape.cc:initCorners(), invalid argument: " << screen << "\n";
-        return;
-    }
+Shape::Key::Key():
+    width(0), height(0), border_width(0), places(0),
+    source(false), source_x(0), source_y(0),
+    source_width(0), source_height(0) {
+}
 
-    static const unsigned char left_bits[] = { 0xc0, 0xf8, 0xfc, 0xfe, 0xfe, 0xfe, 0xff, 0xff };
-    static const unsigned char right_bits[] = { 0x03, 0x1f, 0x3f, 0x7f, 0x7f, 0x7f, 0xff, 0xff};
-    static const unsigned char bottom_left_bits[] = { 0xff, 0xff, 0xfe, 0xfe, 0xfe, 0xfc, 0xf8, 0xc0 };
-    static const unsigned char bottom_right_bits[] = { 0xff, 0xff, 0x7f, 0x7f, 0x7f, 0x3f, 0x1f, 0x03 };
+bool Shape::Key::operator == (const Key &other) const {
+    return !(*this < other) && !(other < *this);
+}
 
-    CornerPixmaps& corners = s_corners[screen];
-    if (corners.do_create) {
+bool Shape::Key::operator < (const Key &other) const {
+    const int mine[] = { width, height, border_width, places, source,
+                         source_x, source_y, source_width, source_height };
+    const int theirs[] = { other.width, other.height, other.border_width,
+                           other.places, other.source, other.source_x,
+                           other.source_y, other.source_width,
+                           other.source_height };
+    return std::lexicographical_compare(mine, mine + sizeof(mine) / sizeof(int),
+                                        theirs, theirs + sizeof(theirs) / sizeof(int));
+}
 
-        Window root = RootWindow(disp, screen);
-        corners.topleft = makePixmap(disp, screen, root, left_bits);
-        corners.topright = makePixmap(disp, screen, root, right_bits);
-        corners.botleft = makePixmap(disp, screen, root, bottom_left_bits);
-        corners.botright = makePixmap(disp, screen, root, bottom_right_bits);
-        corners.do_create = false;
+void Shape::roundedBox(int x, int y, int width, int height, int places,
+                       std::vector<XRectangle> &rects) {
+    int row = 0;
+    while (row < height) {
+        // the rows between the corners are all alike
+        int end = row + 1;
+        if (row >= 8 && row < height - 8)
+            end = height - 8;
+
+        int left, right;
+        rowCut(row, height, places, left, right);
+        XRectangle *last = rects.empty() ? 0 : &rects.back();
+        if (last != 0 && last->y + last->height == y + row &&
+            last->x == x + left && last->width == width - left - right)
+            last->height += end - row;
+        else
+            addRect(rects, x + left, y + row, width - left - right, end - row);
+        row = end;
     }
-
-    nr_shapes++; // refcounting
 }
 
-void cleanCorners() {
+Shape::Rects &Shape::rects(const Key &key) {
+    typedef std::map<Key, Rects> Cache;
+    static Cache cache;
 
-    if (nr_shapes == 1) {
-        s_corners.clear();
-    }
+    Cache::iterator it = cache.find(key);
+    if (it != cache.end())
+        return it->second;
+
+    // sizes seen while resizing pile up, start over once in a while
+    if (cache.size() >= 256)
+        cache.clear();
 
-    if (nr_shapes > 0) {
-        nr_shapes--; // refcounting
+    Rects &rects = cache[key];
+    int bw = key.border_width;
+    if (!key.source) {
+        roundedBox(0, 0, key.width, key.height, key.places, rects.clip);
+        roundedBox(-bw, -bw, key.width + 2*bw, key.height + 2*bw,
+                   key.places, rects.bound);
+    } else {
+        XRectangle area;
+        area.x = key.source_x;
+        area.y = key.source_y;
+        area.width = key.source_width;
+        area.height = key.source_height;
+        boxWithout(0, 0, key.width, key.height, area, rects.clip);
+        boxWithout(-bw, -bw, key.width + 2*bw, key.height + 2*bw, area, rects.bound);
+        cornerCuts(0, 0, key.width, key.height, key.places, rects.clip_cut);
+        cornerCuts(-bw, -bw, key.width + 2*bw, key.height + 2*bw,
+                   key.places, rects.bound_cut);
     }
+    return rects;
 }
 
-} // end of anonymous namespace
-
 Shape::Shape(FbWindow &win, int shapeplaces):
     m_win(&win),
     m_shapesource(0),
     m_shapesource_xoff(0),
     m_shapesource_yoff(0),
-    m_shapeplaces(shapeplaces) {
-
-#ifdef SHAPE
-    initCorners(win.screenNumber());
-#endif
+    m_shapeplaces(shapeplaces),
+    m_is_applied(false) {
 
     update();
 }
@@ -188,8 +229,6 @@ Shape::~Shape() {
                           0,
                           ShapeSet);
     }
-
-    cleanCorners();
 #endif // SHAPE
 }
 
@@ -207,11 +246,34 @@ void Shape::update() {
      * or wipe the shape and return.
      */
     Display *display = App::instance()->display();
-    int bw = m_win->borderWidth();
-    int width = m_win->width();
-    int height = m_win->height();
+    Key key;
+    key.width = m_win->width();
+    key.height = m_win->height();
+    key.border_width = m_win->borderWidth();
+    key.places = m_shapeplaces;
+    if (m_shapesource != 0) {
+        key.source = true;
+        key.source_x = m_shapesource_xoff;
+        key.source_y = m_shapesource_yoff;
+        key.source_width = m_shapesource->width();
+        key.source_height = m_shapesource->height();
+
+        // round the top corners only with something above the source
+        if (key.source_y == 0)
+            key.places &= ~(TOPLEFT | TOPRIGHT);
+        // and the bottom ones with something below or when shaded
+        if (key.source_y + key.source_height >= key.height &&
+            key.source_y < key.height)
+            key.places &= ~(BOTTOMLEFT | BOTTOMRIGHT);
+    }
+
+    // the source's shape may have changed, so that one is always sent
+    if (m_is_applied && !key.source && key == m_applied)
+        return;
+    m_applied = key;
+    m_is_applied = true;
 
-    if (m_shapesource == 0 && m_shapeplaces == 0) {
+    if (!key.source && m_shapeplaces == 0) {
         /* clear the shape and return */
         XShapeCombineMask(display,
                           m_win->window(), ShapeClip,
@@ -224,116 +286,49 @@ void Shape::update() {
         return;
     }
 
-    Region clip = XCreateRegion();
-    Region bound = XCreateRegion();
-
-    XRectangle rect;
-    rect.x = 0;
-    rect.y = 0;
-    rect.width = width;
-    rect.height = height;
-
-    XUnionRectWithRegion(&rect, clip, clip);
-
-    rect.x = -bw;
-    rect.y = -bw;
-    rect.width = width+2*bw;
-    rect.height = height+2*bw;
-
-    XUnionRectWithRegion(&rect, bound, bound);
-
-    if (m_shapesource != 0) {
-
-        /*
-          Copy the shape from the source.
-          We achieve this by subtracting the client-area size from the shape, and then
-          unioning in the client's mask.
-        */
-        rect.x = m_shapesource_xoff;
-        rect.y = m_shapesource_yoff;
-        rect.width = m_shapesource->width();
-        rect.height = m_shapesource->height();
-
-        Region clientarea = XCreateRegion();
-        XUnionRectWithRegion(&rect, clientarea, clientarea);
-        XSubtractRegion(clip, clientarea, clip);
-        XSubtractRegion(bound, clientarea, bound);
-        XDestroyRegion(clientarea);
-
-        XShapeCombineShape(display,
-                           m_win->window(), ShapeClip,
-                           rect.x, rect.y, // xOff, yOff
-                           m_shapesource->window(),
-                           ShapeClip, ShapeSet);
-
-        XShapeCombineRegion(display,
-                            m_win->window(), ShapeClip,
-                            0, 0, // offsets
-                            clip, ShapeUnion);
-
-        /* 
-           Now the bounding rectangle. Note that the frame has a shared border with the region above the 
-           client (i.e. titlebar), so we don't want to wipe the shared border, hence the adjustments.
-        */
-
-        XShapeCombineShape(display,
-                           m_win->window(), ShapeBounding,
-                           rect.x, rect.y, // xOff, yOff
-                           m_shapesource->window(),
-                           ShapeBounding, ShapeSet);
-
-        XShapeCombineRegion(display,
-                            m_win->window(), ShapeBounding,
-                            0, 0, // offsets
-                            bound, ShapeUnion);
-    } else {
-        XShapeCombineRegion(display,
-                            m_win->window(), ShapeClip,
-                            0, 0, // offsets
-                            clip, ShapeSet);
-        XShapeCombineRegion(display,
-                            m_win->window(), ShapeBounding,
-                            0, 0, // offsets
-                            bound, ShapeSet);
-    }
-
-    XDestroyRegion(clip);
-    XDestroyRegion(bound);
-
-   const CornerPixmaps &corners = s_corners[m_win->screenNumber()];
-#define SHAPECORNER(corner, x, y, shapekind)            \
-    XShapeCombineMask(App::instance()->display(), \
-                      m_win->window(),                  \
-                      shapekind,                        \
-                      x, y,                             \
-                      corners.corner.drawable(),      \
-                      ShapeSubtract); 
+    Rects &shape = rects(key);
 
-    /**
-     * Set the top corners if the y offset is nonzero.
-     */
-    if (m_shapesource == 0 || m_shapesource_yoff != 0) {
-        if (m_shapeplaces & TOPLEFT) {
-            SHAPECORNER(topleft, 0, 0, ShapeClip);
-            SHAPECORNER(topleft, -bw, -bw, ShapeBounding);
-        }
-        if (m_shapeplaces & TOPRIGHT) {
-            SHAPECORNER(topright, width-8, 0, ShapeClip);
-            SHAPECORNER(topright, width+bw-8, -bw, ShapeBounding);
-        }
+    if (!key.source) {
+        XShapeCombineRectangles(display, m_win->window(), ShapeClip, 0, 0,
+                                data(shape.clip), shape.clip.size(),
+                                ShapeSet, YXBanded);
+        XShapeCombineRectangles(display, m_win->window(), ShapeBounding, 0, 0,
+                                data(shape.bound), shape.bound.size(),
+                                ShapeSet, YXBanded);
+        return;
     }
 
-    // note that the bottom corners y-vals are offset by 8 (the height of the corner pixmaps)
-    if (m_shapesource == 0 || (m_shapesource_yoff+(signed) m_shapesource->height()) < height
-        || m_shapesource_yoff >= height /* shaded */) {
-        if (m_shapeplaces & BOTTOMLEFT) {
-            SHAPECORNER(botleft, 0, height-8, ShapeClip);
-            SHAPECORNER(botleft, -bw, height+bw-8, ShapeBounding);
-        }
-        if (m_shapeplaces & BOTTOMRIGHT) {
-            SHAPECORNER(botright, width-8, height-8, ShapeClip);
-            SHAPECORNER(botright, width+bw-8, height+bw-8, ShapeBounding);
-        }
+    /*
+      Copy the shape from the source, then add what's around the client
+      area, e.g. the titlebar. Note that the frame has a shared border
+      with the region above the client (i.e. titlebar), so the bounding
+      rectangle keeps that border.
+    */
+    XShapeCombineShape(display,
+                       m_win->window(), ShapeClip,
+                       key.source_x, key.source_y,
+                       m_shapesource->window(),
+                       ShapeClip, ShapeSet);
+    XShapeCombineRectangles(display, m_win->window(), ShapeClip, 0, 0,
+                            data(shape.clip), shape.clip.size(),
+                            ShapeUnion, YXBanded);
+
+    XShapeCombineShape(display,
+                       m_win->window(), ShapeBounding,
+                       key.source_x, key.source_y,
+                       m_shapesource->window(),
+                       ShapeBounding, ShapeSet);
+    XShapeCombineRectangles(display, m_win->window(), ShapeBounding, 0, 0,
+                            data(shape.bound), shape.bound.size(),
+                            ShapeUnion, YXBanded);
+
+    if (key.places != 0) {
+        XShapeCombineRectangles(display, m_win->window(), ShapeClip, 0, 0,
+                                data(shape.clip_cut), shape.clip_cut.size(),
+                                ShapeSubtract, Unsorted);
+        XShapeCombineRectangles(display, m_win->window(), ShapeBounding, 0, 0,
+                                data(shape.bound_cut), shape.bound_cut.size(),
+                                ShapeSubtract, Unsorted);
     }
 
 #endif // SHAPE
@@ -342,6 +337,7 @@ void Shape::update() {
 
 void Shape::setWindow(FbWindow &win) {
     m_win = &win;
+    m_is_applied = false;
     update();
 }
 
@@ -24,6 +24,10 @@
 
 #include "FbPixmap.hh"
 
+#include <X11/Xlib.h>
+
+#include <vector>
+
 namespace FbTk {
 class FbWindow;
 
@@ -58,12 +62,39 @@ public:
     static void setShapeNotify(const FbWindow &win);
     /// @return true if window has shape
     static bool isShaped(const FbWindow &win);
+    /**
+       Covers a box with the corners in places rounded off, one rectangle
+       per band from top to bottom
+    */
+    static void roundedBox(int x, int y, int width, int height, int places,
+                           std::vector<XRectangle> &rects);
 private:
+    /// what a shape depends on, besides the shape of the source
+    struct Key {
+        Key();
+        bool operator == (const Key &other) const;
+        bool operator < (const Key &other) const;
+
+        int width, height, border_width;
+        int places; ///< corners which are actually rounded
+        bool source;
+        int source_x, source_y, source_width, source_height;
+    };
+    struct Rects {
+        std::vector<XRectangle> clip, bound;
+        /// corners cut off after the source is merged in
+        std::vector<XRectangle> clip_cut, bound_cut;
+    };
+    /// @return rectangles for key, from a cache shared by all shapes
+    static Rects &rects(const Key &key);
+
     FbWindow *m_win; ///< window to be shaped
     FbWindow *m_shapesource; ///< window to pull shape from
     int m_shapesource_xoff, m_shapesource_yoff;
 
     int m_shapeplaces; ///< places to shape
+    Key m_applied; ///< what the window was shaped to last
+    bool m_is_applied;
 };
 
 } // end namespace FbTk
@@ -0,0 +1,203 @@
+// Signal.cc for FbTk, Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "Signal.hh"
+
+namespace FbTk {
+
+namespace SigImpl {
+
+SlotEntry::SlotEntry(const SlotEntry &other):
+    m_manager(other.m_manager),
+    m_caller(other.m_caller),
+    m_id(other.m_id),
+    m_connected(other.m_connected),
+    m_inline(other.m_inline) {
+    m_manager->copy(m_storage, other.m_storage);
+}
+
+SlotEntry::~SlotEntry() {
+    m_manager->destroy(m_storage);
+}
+
+SlotEntry &SlotEntry::operator = (const SlotEntry &other) {
+    if (this != &other) {
+        m_manager->destroy(m_storage);
+        m_manager = other.m_manager;
+        m_caller = other.m_caller;
+        m_id = other.m_id;
+        m_connected = other.m_connected;
+        m_inline = other.m_inline;
+        m_manager->copy(m_storage, other.m_storage);
+    }
+    return *this;
+}
+
+SlotList::SlotList():
+    m_entries(reinterpret_cast<SlotEntry *>(m_inline.bytes)),
+    m_size(0),
+    m_capacity(INLINE_ENTRIES) {
+}
+
+SlotList::SlotList(const SlotList &other):
+    m_entries(reinterpret_cast<SlotEntry *>(m_inline.bytes)),
+    m_size(0),
+    m_capacity(INLINE_ENTRIES) {
+    *this = other;
+}
+
+SlotList::~SlotList() {
+    clear();
+    if (m_entries != reinterpret_cast<SlotEntry *>(m_inline.bytes))
+        ::operator delete(m_entries);
+}
+
+SlotList &SlotList::operator = (const SlotList &other) {
+    if (this != &other) {
+        clear();
+        reserve(other.m_size);
+        for (size_t i = 0; i < other.m_size; ++i)
+            push_back(other.m_entries[i]);
+    }
+    return *this;
+}
+
+void SlotList::push_back(const SlotEntry &entry) {
+    if (m_size == m_capacity)
+        reserve(m_capacity * 2);
+    new (m_entries + m_size) SlotEntry(entry);
+    ++m_size;
+}
+
+SlotEntry *SlotList::find(unsigned long id) {
+    // ids grow with every connect, so the entries are sorted by them
+    size_t low = 0, high = m_size;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (m_entries[mid].id() < id)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low < m_size && m_entries[low].id() == id)
+        return m_entries + low;
+    return 0;
+}
+
+void SlotList::erase(unsigned long id) {
+    SlotEntry *entry = find(id);
+    if (entry == 0)
+        return;
+    entry->disconnect();
+    compact();
+}
+
+void SlotList::compact() {
+    size_t to = 0;
+    for (size_t from = 0; from < m_size; ++from) {
+        if (!m_entries[from].connected())
+            continue;
+        if (to != from)
+            m_entries[to] = m_entries[from];
+        ++to;
+    }
+    while (m_size > to)
+        m_entries[--m_size].~SlotEntry();
+}
+
+void SlotList::clear() {
+    while (m_size > 0)
+        m_entries[--m_size].~SlotEntry();
+}
+
+void SlotList::reserve(size_t capacity) {
+    if (capacity <= m_capacity)
+        return;
+
+    SlotEntry *entries = static_cast<SlotEntry *>(::operator new(capacity * sizeof(SlotEntry)));
+    for (size_t i = 0; i < m_size; ++i) {
+        new (entries + i) SlotEntry(m_entries[i]);
+        m_entries[i].~SlotEntry();
+    }
+    if (m_entries != reinterpret_cast<SlotEntry *>(m_inline.bytes))
+        ::operator delete(m_entries);
+    m_entries = entries;
+    m_capacity = capacity;
+}
+
+SignalHolder::~SignalHolder() {
+    // Disconnect this holder from all trackers.
+    // A tracker might leave while we go, so work on a copy.
+    Trackers trackers;
+    trackers.swap(m_trackers);
+    for (Trackers::iterator it = trackers.begin(), it_end = trackers.end();
+         it != it_end; ++it ) {
+        (*it)->disconnect(*this);
+    }
+}
+
+void SignalHolder::disconnect(SlotID id) const {
+    if (m_emitting) {
+        // if we are emitting, we must not move the entries, as the
+        // emit() function still walks them
+        SlotEntry *entry = m_slots.find(id);
+        if (entry != 0) {
+            entry->disconnect();
+            m_dirty = true;
+        } else
+            m_pending.erase(id);
+    } else
+        m_slots.erase(id);
+}
+
+void SignalHolder::clear() {
+    if (m_emitting) {
+        for (size_t i = 0; i < m_slots.size(); ++i)
+            m_slots[i].disconnect();
+        m_pending.clear();
+        m_dirty = true;
+    } else
+        m_slots.clear();
+}
+
+void SignalHolder::connectTracker(SignalHolder::Tracker& tracker) const {
+    if (std::find(m_trackers.begin(), m_trackers.end(), &tracker) == m_trackers.end())
+        m_trackers.push_back(&tracker);
+}
+
+void SignalHolder::disconnectTracker(SignalHolder::Tracker& tracker) const {
+    Trackers::iterator it = std::find(m_trackers.begin(), m_trackers.end(), &tracker);
+    if (it != m_trackers.end())
+        m_trackers.erase(it);
+}
+
+void SignalHolder::update() {
+    // remove elements which belonged slots that detached themselves
+    m_slots.compact();
+    for (size_t i = 0; i < m_pending.size(); ++i)
+        m_slots.push_back(m_pending[i]);
+    m_pending.clear();
+    m_dirty = false;
+}
+
+} // namespace SigImpl
+
+} // namespace FbTk
@@ -25,25 +25,164 @@
 #include "RefCount.hh"
 #include "Slot.hh"
 #include <algorithm>
-#include <list>
 #include <map>
-#include <set>
+#include <new>
+#include <vector>
+#include <cstdlib> // size_t
 
 namespace FbTk {
 
 /// \namespace Implementation details for signals, do not use anything in this namespace
 namespace SigImpl {
 
+/**
+ * A copy of a connected functor. Functors up to INLINE_SIZE bytes (member
+ * function pointers with an object and a bound argument) live in the entry
+ * itself, bigger ones on the heap. The signal knows the argument types and
+ * calls the functor through \c caller().
+ */
+class SlotEntry {
+public:
+    enum { INLINE_SIZE = 4 * sizeof(void *) };
+
+    /// really a void (*)(void *functor, Arg1, ...) of the signal
+    typedef void (*Caller)();
+
+    template <typename Functor>
+    SlotEntry(const Functor &functor, Caller caller, unsigned long id);
+    SlotEntry(const SlotEntry &other);
+    ~SlotEntry();
+    SlotEntry &operator = (const SlotEntry &other);
+
+    unsigned long id() const { return m_id; }
+    /// disconnected entries are skipped and removed after the emit
+    bool connected() const { return m_connected; }
+    void disconnect() { m_connected = false; }
+
+    Caller caller() const { return m_caller; }
+    void *functor() { return m_inline ? m_storage.bytes : m_storage.pointer; }
+
+private:
+    union Storage {
+        char bytes[INLINE_SIZE];
+        void *pointer;
+        void (*function)();
+        double number;
+    };
+
+    struct Manager {
+        void (*copy)(Storage &to, const Storage &from);
+        void (*destroy)(Storage &storage);
+    };
+
+    template <typename Functor, bool Inline>
+    struct Managed;
+
+    Storage m_storage;
+    const Manager *m_manager;
+    Caller m_caller;
+    unsigned long m_id;
+    bool m_connected;
+    bool m_inline;
+};
+
+/// keeps the functor in the entry
+template <typename Functor>
+struct SlotEntry::Managed<Functor, true> {
+    static void copy(Storage &to, const Storage &from) {
+        new (to.bytes) Functor(*reinterpret_cast<const Functor *>(from.bytes));
+    }
+    static void destroy(Storage &storage) {
+        reinterpret_cast<Functor *>(storage.bytes)->~Functor();
+    }
+    static void create(Storage &storage, const Functor &functor) {
+        new (storage.bytes) Functor(functor);
+    }
+    static const Manager manager;
+};
+
+/// keeps the functor on the heap
+template <typename Functor>
+struct SlotEntry::Managed<Functor, false> {
+    static void copy(Storage &to, const Storage &from) {
+        to.pointer = new Functor(*static_cast<const Functor *>(from.pointer));
+    }
+    static void destroy(Storage &storage) {
+        delete static_cast<Functor *>(storage.pointer);
+    }
+    static void create(Storage &storage, const Functor &functor) {
+        storage.pointer = new Functor(functor);
+    }
+    static const Manager manager;
+};
+
+template <typename Functor>
+const SlotEntry::Manager SlotEntry::Managed<Functor, true>::manager = {
+    &SlotEntry::Managed<Functor, true>::copy,
+    &SlotEntry::Managed<Functor, true>::destroy
+};
+
+template <typename Functor>
+const SlotEntry::Manager SlotEntry::Managed<Functor, false>::manager = {
+    &SlotEntry::Managed<Functor, false>::copy,
+    &SlotEntry::Managed<Functor, false>::destroy
+};
+
+template <typename Functor>
+SlotEntry::SlotEntry(const Functor &functor, Caller caller, unsigned long id):
+    m_caller(caller), m_id(id), m_connected(true),
+    m_inline(sizeof(Functor) <= INLINE_SIZE) {
+    typedef Managed<Functor, sizeof(Functor) <= INLINE_SIZE> Impl;
+    Impl::create(m_storage, functor);
+    m_manager = &Impl::manager;
+}
+
+/**
+ * The entries of a signal in connection order, so ids are ascending.
+ * The first INLINE_ENTRIES are kept in the list itself.
+ */
+class SlotList {
+public:
+    enum { INLINE_ENTRIES = 2 };
+
+    SlotList();
+    SlotList(const SlotList &other);
+    ~SlotList();
+    SlotList &operator = (const SlotList &other);
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    SlotEntry &operator [] (size_t i) { return m_entries[i]; }
+
+    void push_back(const SlotEntry &entry);
+    /// @return entry with the id or 0
+    SlotEntry *find(unsigned long id);
+    void erase(unsigned long id);
+    /// removes all disconnected entries
+    void compact();
+    void clear();
+
+private:
+    void reserve(size_t capacity);
+
+    union InlineEntries {
+        char bytes[INLINE_ENTRIES * sizeof(SlotEntry)];
+        void *pointer;
+        double number;
+    };
+
+    SlotEntry *m_entries;
+    size_t m_size;
+    size_t m_capacity;
+    InlineEntries m_inline;
+};
+
 /**
  * Parent class for all \c Signal template classes.
  * It handles the disconnect and holds all the slots. The connect must be
  * handled by the child class so it can do the type checking.
  */
 class SignalHolder {
-protected:
-    typedef RefCount<SlotBase> SlotPtr;
-    typedef std::list<SlotPtr> SlotList;
-
 public:
     /// Special tracker interface used by SignalTracker.
     class Tracker {
@@ -53,72 +192,75 @@ public:
         virtual void disconnect(SignalHolder& signal) = 0;
     };
 
-    typedef SlotList::iterator Iterator;
-    typedef Iterator SlotID;
-    typedef SlotList::const_iterator ConstIterator;
+    /// identifies a connection, never reused within one signal
+    typedef unsigned long SlotID;
 
-    SignalHolder() : m_emitting(0) {}
+    SignalHolder() : m_emitting(0), m_dirty(false), m_next_id(1) {}
 
-    ~SignalHolder() {
-        // Disconnect this holder from all trackers.
-        for (Trackers::iterator it = m_trackers.begin(),
-                 it_end = m_trackers.end();
-             it != it_end; ++it ) {
-            (*it)->disconnect(*this);
-        }
-    }
+    ~SignalHolder();
 
     /// Remove a specific slot \c id from this signal
-    void disconnect(SlotID slotIt) const {
-        if(m_emitting) {
-            // if we are emitting, we must not erase the actual element, as that would
-            // invalidate iterators in the emit() function
-            *slotIt = SlotPtr();
-        } else
-            m_slots.erase( slotIt );
-    }
-
+    void disconnect(SlotID id) const;
 
     /// Removes all slots connected to this
-    void clear() {
-        if(m_emitting)
-            std::fill(m_slots.begin(), m_slots.end(), SlotPtr());
-        else
-            m_slots.clear();
-    }
-
-    void connectTracker(SignalHolder::Tracker& tracker) const {
-        m_trackers.insert(&tracker);
-    }
+    void clear();
 
-    void disconnectTracker(SignalHolder::Tracker& tracker) const {
-        m_trackers.erase(&tracker);
-    }
+    void connectTracker(SignalHolder::Tracker& tracker) const;
+    void disconnectTracker(SignalHolder::Tracker& tracker) const;
 
 protected:
-    ConstIterator begin() const { return m_slots.begin(); }
-    ConstIterator end() const { return m_slots.end(); }
-
-    Iterator begin() { return m_slots.begin(); }
-    Iterator end() { return m_slots.end(); }
-
-    /// Connect a slot to this signal. Must only be called by child classes.
-    SlotID connect(const SlotPtr& slot) const {
-        return m_slots.insert(m_slots.end(), slot);
+    /// Connect a functor to this signal. Must only be called by child classes.
+    template <typename Functor>
+    SlotID connect(const Functor &functor, SlotEntry::Caller caller) const {
+        SlotID id = m_next_id++;
+        // while emitting, the entries being called must not move
+        if (m_emitting) {
+            m_pending.push_back(SlotEntry(functor, caller, id));
+            m_dirty = true;
+        } else
+            m_slots.push_back(SlotEntry(functor, caller, id));
+        return id;
     }
 
+    /// slots connected while emitting are not called before the next emit
+    size_t size() const { return m_slots.size(); }
+    SlotEntry &entry(size_t i) { return m_slots[i]; }
+
     void begin_emitting() { ++m_emitting; }
     void end_emitting() {
-        if(--m_emitting == 0) {
-            // remove elements which belonged slots that detached themselves
-            m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), SlotPtr()), m_slots.end());
-        }
+        if (--m_emitting == 0 && m_dirty)
+            update();
     }
+
 private:
-    typedef std::set<Tracker*> Trackers;
+    /// applies the changes made while emitting
+    void update();
+
+    typedef std::vector<Tracker*> Trackers;
     mutable SlotList m_slots; ///< all slots connected to a signal
+    mutable SlotList m_pending; ///< slots connected while emitting
     mutable Trackers m_trackers; ///< all instances that tracks this signal.
     unsigned m_emitting;
+    mutable bool m_dirty; ///< slots were connected or disconnected while emitting
+    mutable SlotID m_next_id;
+};
+
+/// calls a ref counted Slot, for connectSlot
+template <typename SlotType>
+class SlotCaller {
+public:
+    explicit SlotCaller(const RefCount<SlotType> &slot): m_slot(slot) { }
+
+    void operator()() const { (*m_slot)(); }
+    template <typename Arg1>
+    void operator()(Arg1 arg1) const { (*m_slot)(arg1); }
+    template <typename Arg1, typename Arg2>
+    void operator()(Arg1 arg1, Arg2 arg2) const { (*m_slot)(arg1, arg2); }
+    template <typename Arg1, typename Arg2, typename Arg3>
+    void operator()(Arg1 arg1, Arg2 arg2, Arg3 arg3) const { (*m_slot)(arg1, arg2, arg3); }
+
+private:
+    RefCount<SlotType> m_slot;
 };
 
 } // namespace SigImpl
@@ -127,100 +269,132 @@ private:
 /// Specialization for three arguments.
 template <typename Arg1 = SigImpl::EmptyArg, typename Arg2 = SigImpl::EmptyArg, typename Arg3 = SigImpl::EmptyArg >
 class Signal: public SigImpl::SignalHolder {
+    typedef void (*Caller)(void *, Arg1, Arg2, Arg3);
+
+    template <typename Functor>
+    static void call(void *functor, Arg1 arg1, Arg2 arg2, Arg3 arg3) {
+        (*static_cast<Functor *>(functor))(arg1, arg2, arg3);
+    }
+
 public:
     void emit(Arg1 arg1, Arg2 arg2, Arg3 arg3) {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void, Arg1, Arg2, Arg3> &>(**it)(arg1, arg2, arg3);
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            SigImpl::SlotEntry &slot = entry(i);
+            if (slot.connected())
+                reinterpret_cast<Caller>(slot.caller())(slot.functor(), arg1, arg2, arg3);
         }
         end_emitting();
     }
 
     template<typename Functor>
     SlotID connect(const Functor& functor) const {
-        return SignalHolder::connect(SlotPtr(
-                        new SlotImpl<Functor, void, Arg1, Arg2, Arg3>(functor)
-                    ));
+        Caller caller = &Signal::call<Functor>;
+        return SignalHolder::connect(functor,
+                reinterpret_cast<SigImpl::SlotEntry::Caller>(caller));
     }
 
     SlotID connectSlot(const RefCount<FbTk::Slot<void, Arg1, Arg2, Arg3> > &slot) const {
-        return SignalHolder::connect(slot);
+        return connect(SigImpl::SlotCaller<FbTk::Slot<void, Arg1, Arg2, Arg3> >(slot));
     }
 };
 
 /// Specialization for two arguments.
 template <typename Arg1, typename Arg2>
 class Signal<Arg1, Arg2, SigImpl::EmptyArg>: public SigImpl::SignalHolder {
+    typedef void (*Caller)(void *, Arg1, Arg2);
+
+    template <typename Functor>
+    static void call(void *functor, Arg1 arg1, Arg2 arg2) {
+        (*static_cast<Functor *>(functor))(arg1, arg2);
+    }
+
 public:
     void emit(Arg1 arg1, Arg2 arg2) {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void, Arg1, Arg2> &>(**it)(arg1, arg2);
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            SigImpl::SlotEntry &slot = entry(i);
+            if (slot.connected())
+                reinterpret_cast<Caller>(slot.caller())(slot.functor(), arg1, arg2);
         }
         end_emitting();
     }
 
     template<typename Functor>
     SlotID connect(const Functor& functor) const {
-        return SignalHolder::connect(SlotPtr(
-                        new SlotImpl<Functor, void, Arg1, Arg2>(functor)
-                    ));
+        Caller caller = &Signal::call<Functor>;
+        return SignalHolder::connect(functor,
+                reinterpret_cast<SigImpl::SlotEntry::Caller>(caller));
     }
 
     SlotID connectSlot(const RefCount<FbTk::Slot<void, Arg1, Arg2> > &slot) const {
-        return SignalHolder::connect(slot);
+        return connect(SigImpl::SlotCaller<FbTk::Slot<void, Arg1, Arg2> >(slot));
     }
 };
 
 /// Specialization for one argument.
 template <typename Arg1>
 class Signal<Arg1, SigImpl::EmptyArg, SigImpl::EmptyArg>: public SigImpl::SignalHolder {
+    typedef void (*Caller)(void *, Arg1);
+
+    template <typename Functor>
+    static void call(void *functor, Arg1 arg1) {
+        (*static_cast<Functor *>(functor))(arg1);
+    }
+
 public:
     void emit(Arg1 arg) {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void, Arg1> &>(**it)(arg);
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            SigImpl::SlotEntry &slot = entry(i);
+            if (slot.connected())
+                reinterpret_cast<Caller>(slot.caller())(slot.functor(), arg);
         }
         end_emitting();
     }
 
     template<typename Functor>
     SlotID connect(const Functor& functor) const {
-        return SignalHolder::connect(SlotPtr(
-                        new SlotImpl<Functor, void, Arg1>(functor)
-                    ));
+        Caller caller = &Signal::call<Functor>;
+        return SignalHolder::connect(functor,
+                reinterpret_cast<SigImpl::SlotEntry::Caller>(caller));
     }
 
     SlotID connectSlot(const RefCount<FbTk::Slot<void, Arg1> > &slot) const {
-        return SignalHolder::connect(slot);
+        return connect(SigImpl::SlotCaller<FbTk::Slot<void, Arg1> >(slot));
     }
 };
 
 /// Specialization for no arguments.
 template <>
 class Signal<SigImpl::EmptyArg, SigImpl::EmptyArg, SigImpl::EmptyArg>: public SigImpl::SignalHolder {
+    typedef void (*Caller)(void *);
+
+    template <typename Functor>
+    static void call(void *functor) {
+        (*static_cast<Functor *>(functor))();
+    }
+
 public:
     void emit() {
         begin_emitting();
-        for ( Iterator it = begin(); it != end(); ++it ) {
-            if(*it)
-                static_cast<Slot<void> &>(**it)();
+        for (size_t i = 0, n = size(); i < n; ++i) {
+            SigImpl::SlotEntry &slot = entry(i);
+            if (slot.connected())
+                reinterpret_cast<Caller>(slot.caller())(slot.functor());
         }
         end_emitting();
     }
 
     template<typename Functor>
     SlotID connect(const Functor& functor) const {
-        return SignalHolder::connect(SlotPtr(
-                        new SlotImpl<Functor, void>(functor)
-                    ));
+        Caller caller = &Signal::call<Functor>;
+        return SignalHolder::connect(functor,
+                reinterpret_cast<SigImpl::SlotEntry::Caller>(caller));
     }
 
     SlotID connectSlot(const RefCount<FbTk::Slot<void> > &slot) const {
-        return SignalHolder::connect(slot);
+        return connect(SigImpl::SlotCaller<FbTk::Slot<void> >(slot));
     }
 };
 
@@ -243,26 +417,14 @@ public:
     /// @return A tracking ID
     template<typename Arg1, typename Arg2, typename Arg3, typename Functor>
     TrackID join(const Signal<Arg1, Arg2, Arg3> &sig, const Functor &functor) {
-        return joinSlot(sig, RefCount<Slot<void, Arg1, Arg2, Arg3> >(
-                    new SlotImpl<Functor, void, Arg1, Arg2, Arg3>(functor)
-                    ));
+        return track(sig, sig.connect(functor));
     }
 
     template<typename Arg1, typename Arg2, typename Arg3>
     TrackID
     joinSlot(const Signal<Arg1, Arg2, Arg3> &sig,
             const RefCount<Slot<void, Arg1, Arg2, Arg3> > &slot) {
-
-        ValueType value = ValueType(&sig, sig.connectSlot(slot));
-        std::pair<TrackID, bool> ret = m_connections.insert(value);
-        if ( !ret.second ) {
-            // failed to insert this functor
-            sig.disconnect(value.second);
-        }
-
-        sig.connectTracker(*this);
-
-        return ret.first;
+        return track(sig, sig.connectSlot(slot));
     }
 
     /// Leave tracking for a signal
@@ -303,6 +465,20 @@ protected:
 private:
     typedef Connections::value_type ValueType;
     typedef Connections::iterator Iterator;
+
+    TrackID track(const SigImpl::SignalHolder &sig, SigImpl::SignalHolder::SlotID id) {
+        ValueType value = ValueType(&sig, id);
+        std::pair<TrackID, bool> ret = m_connections.insert(value);
+        if ( !ret.second ) {
+            // failed to insert this functor
+            sig.disconnect(value.second);
+        }
+
+        sig.connectTracker(*this);
+
+        return ret.first;
+    }
+
     /// holds all connections to different signals and slots.
     Connections m_connections;
 };
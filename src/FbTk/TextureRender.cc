@@ -33,10 +33,21 @@
 #include "I18n.hh"
 #include "StringUtil.hh"
 #include "ColorLUT.hh"
+#include "WorkerPool.hh"
 
 #include <X11/Xutil.h>
 #include <iostream>
 
+#ifdef HAVE_CSTRING
+  #include <cstring>
+#else
+  #include <string.h>
+#endif
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <immintrin.h>
+#endif // __GNUC__ && __SSE2__
+
 // mipspro has no new(nothrow)
 #if defined sgi && ! defined GCC
 #define FB_new_nothrow new
@@ -147,6 +158,138 @@ void mirrorRGB(unsigned int w, unsigned int h, FbTk::RGBA* rgba) {
 }
 
 
+// the common TrueColor case: 8 bits per channel, 32 bits per pixel and the
+// color tables do not change anything. each pixel is then just a
+// shuffle of the bytes of the RGBA value.
+//
+// the RGBA value read as an (little endian) int has red at bit 0, green
+// at bit 8 and blue at bit 16; 'shift' moves them to the offsets of
+// the visual.
+
+struct PackedLayout {
+    int red_offset;
+    int green_offset;
+    int blue_offset;
+
+    unsigned int pack(const FbTk::RGBA& c) const {
+        return (static_cast<unsigned int>(c.r) << red_offset) |
+               (static_cast<unsigned int>(c.g) << green_offset) |
+               (static_cast<unsigned int>(c.b) << blue_offset);
+    }
+};
+
+typedef void (*packFunc)(const FbTk::RGBA*, unsigned char*, size_t, const PackedLayout&);
+
+void packPixelsScalar(const FbTk::RGBA* src, unsigned char* dst, size_t n,
+        const PackedLayout& layout) {
+
+    unsigned int pixel;
+    for (size_t i = 0; i < n; ++i, dst += 4) {
+        pixel = layout.pack(src[i]);
+        memcpy(dst, &pixel, 4);
+    }
+}
+
+#if defined(__GNUC__) && defined(__SSE2__)
+
+// shifts the channel found at bit 'from' to bit 'to'
+inline __m128i moveChannel(__m128i v, int from, int to) {
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(0xffu << to));
+    if (to >= from)
+        return _mm_and_si128(_mm_sll_epi32(v, _mm_cvtsi32_si128(to - from)), mask);
+    return _mm_and_si128(_mm_srl_epi32(v, _mm_cvtsi32_si128(from - to)), mask);
+}
+
+void packPixelsSSE2(const FbTk::RGBA* src, unsigned char* dst, size_t n,
+        const PackedLayout& layout) {
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4, dst += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i p = _mm_or_si128(moveChannel(v, 0, layout.red_offset),
+                          _mm_or_si128(moveChannel(v, 8, layout.green_offset),
+                                       moveChannel(v, 16, layout.blue_offset)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), p);
+    }
+
+    packPixelsScalar(src + i, dst, n - i, layout);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FBTK_HAVE_AVX2_PACK 1
+
+__attribute__((target("avx2")))
+inline __m256i moveChannelAVX2(__m256i v, int from, int to) {
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(0xffu << to));
+    if (to >= from)
+        return _mm256_and_si256(_mm256_sll_epi32(v, _mm_cvtsi32_si128(to - from)), mask);
+    return _mm256_and_si256(_mm256_srl_epi32(v, _mm_cvtsi32_si128(from - to)), mask);
+}
+
+__attribute__((target("avx2")))
+void packPixelsAVX2(const FbTk::RGBA* src, unsigned char* dst, size_t n,
+        const PackedLayout& layout) {
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8, dst += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i p = _mm256_or_si256(moveChannelAVX2(v, 0, layout.red_offset),
+                          _mm256_or_si256(moveChannelAVX2(v, 8, layout.green_offset),
+                                          moveChannelAVX2(v, 16, layout.blue_offset)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), p);
+    }
+
+    packPixelsSSE2(src + i, dst, n - i, layout);
+}
+
+#endif // __x86_64__ || __i386__
+#endif // __GNUC__ && __SSE2__
+
+packFunc selectPackFunc() {
+#ifdef FBTK_HAVE_AVX2_PACK
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return packPixelsAVX2;
+#endif // FBTK_HAVE_AVX2_PACK
+#if defined(__GNUC__) && defined(__SSE2__)
+    return packPixelsSSE2;
+#else
+    return packPixelsScalar;
+#endif
+}
+
+// the vector code reads the RGBA values as ints, which only
+// matches the byte order of the image on little endian hosts
+bool isLSBFirstHost() {
+    const unsigned int one = 1;
+    return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+// transfers the pixels into a LSBFirst 32 bpp image, if the layout allows it
+bool transferPacked32(const FbTk::RGBA* rgba, unsigned int width, unsigned int height,
+        unsigned char* data, size_t bytes_per_line, const PackedLayout& layout) {
+
+    static const packFunc pack = selectPackFunc();
+    static const bool lsb_host = isLSBFirstHost();
+
+    if (!lsb_host ||
+        layout.red_offset < 0 || layout.red_offset > 24 ||
+        layout.green_offset < 0 || layout.green_offset > 24 ||
+        layout.blue_offset < 0 || layout.blue_offset > 24) {
+        return false;
+    }
+
+    if (bytes_per_line == width * 4) {
+        pack(rgba, data, static_cast<size_t>(width) * height, layout);
+    } else {
+        for (unsigned int y = 0; y < height; ++y, rgba += width, data += bytes_per_line)
+            pack(rgba, data, width, layout);
+    }
+
+    return true;
+}
+
+
 
 typedef void (*prepareFunc)(size_t, FbTk::RGBA*, const FbTk::Color*, const FbTk::Color*, double);
 
@@ -331,6 +474,57 @@ void renderBevel2(bool interlaced,
 
 
 
+// the gradients are rendered in bands of rows, possibly in parallel. the
+// tables are prepared upfront, filling a band only reads them.
+struct GradientRows: public FbTk::WorkerPool::Job {
+
+    typedef void (*fillFunc)(const GradientRows&, size_t, size_t);
+
+    GradientRows(fillFunc f, bool i, unsigned int w, unsigned int h,
+                 FbTk::RGBA* data, const FbTk::Color* c_from, const FbTk::Color* c_to,
+                 const FbTk::RGBA* x_grad = 0, const FbTk::RGBA* y_grad = 0) :
+        fill(f), interlaced(i), width(w), height(h), rgba(data),
+        from(c_from), to(c_to), x_gradient(x_grad), y_gradient(y_grad) { }
+
+    void run(size_t begin, size_t end) { fill(*this, begin, end); }
+
+    fillFunc fill;
+    bool interlaced;
+    unsigned int width;
+    unsigned int height;
+    FbTk::RGBA* rgba;
+    const FbTk::Color* from;
+    const FbTk::Color* to;
+    const FbTk::RGBA* x_gradient;
+    const FbTk::RGBA* y_gradient;
+};
+
+FbTk::WorkerPool s_render_pool;
+
+void renderRows(GradientRows& rows) {
+
+    // small textures (the majority) are not worth the overhead
+    // of waking up the pool
+    const size_t min_band_pixels = 16384;
+    const size_t min_band = max(static_cast<size_t>(1), min_band_pixels / max(rows.width, 1u));
+
+    s_render_pool.run(rows, rows.height, min_band);
+}
+
+
+void fillHorizontalRows(const GradientRows& rows, size_t y, size_t y_end) {
+
+    FbTk::RGBA* rgba = rows.rgba + (y * rows.width);
+    size_t x;
+
+    for (; y < y_end; ++y) {
+        for (x = 0; x < rows.width; ++x, ++rgba) {
+            *rgba = rows.x_gradient[x];
+            pseudoInterlace(*rgba, rows.interlaced, y);
+        }
+    }
+}
+
 void renderHorizontalGradient(bool interlaced,
         unsigned int width, unsigned int height,
         FbTk::RGBA* rgba,
@@ -340,14 +534,19 @@ void renderHorizontalGradient(bool interlaced,
     FbTk::RGBA* gradient = (FbTk::RGBA*)&getGradientBuffer(width * sizeof(FbTk::RGBA))[0];
     prepareLinearTable(width, gradient, from, to, 1.0);
 
-    size_t y;
+    GradientRows rows(fillHorizontalRows, interlaced, width, height, rgba, from, to, gradient);
+    renderRows(rows);
+}
+
+void fillVerticalRows(const GradientRows& rows, size_t y, size_t y_end) {
+
+    FbTk::RGBA* rgba = rows.rgba + (y * rows.width);
     size_t x;
-    size_t i;
 
-    for (i = 0, y = 0; y < height; ++y) {
-        for (x = 0; x < width; ++x, ++i) {
-            rgba[i] = gradient[x];
-            pseudoInterlace(rgba[i], interlaced, y);
+    for (; y < y_end; ++y) {
+        for (x = 0; x < rows.width; ++x, ++rgba) {
+            *rgba = rows.y_gradient[y];
+            pseudoInterlace(*rgba, rows.interlaced, y);
         }
     }
 }
@@ -361,19 +560,30 @@ void renderVerticalGradient(bool interlaced,
     FbTk::RGBA* gradient = (FbTk::RGBA*)&getGradientBuffer(height * sizeof(FbTk::RGBA))[0];
     prepareLinearTable(height, gradient, from, to, 1.0);
 
-    size_t y;
+    GradientRows rows(fillVerticalRows, interlaced, width, height, rgba, from, to, 0, gradient);
+    renderRows(rows);
+}
+
+
+// used by pyramid, diagonal and crossdiagonal: the sum of the
+// (pre-scaled) x- and y-gradient
+void fillSumRows(const GradientRows& rows, size_t y, size_t y_end) {
+
+    FbTk::RGBA* rgba = rows.rgba + (y * rows.width);
     size_t x;
-    size_t i;
 
-    for (i = 0, y = 0; y < height; ++y) {
-        for (x = 0; x < width; ++x, ++i) {
-            rgba[i] = gradient[y];
-            pseudoInterlace(rgba[i], interlaced, y);
+    for (; y < y_end; ++y) {
+        for (x = 0; x < rows.width; ++x, ++rgba) {
+
+            rgba->r = rows.x_gradient[x].r + rows.y_gradient[y].r;
+            rgba->g = rows.x_gradient[x].g + rows.y_gradient[y].g;
+            rgba->b = rows.x_gradient[x].b + rows.y_gradient[y].b;
+
+            pseudoInterlace(*rgba, rows.interlaced, y);
         }
     }
 }
 
-
 void renderPyramidGradient(bool interlaced,
         unsigned int width, unsigned int height,
         FbTk::RGBA* rgba,
@@ -390,20 +600,8 @@ void renderPyramidGradient(bool interlaced,
     prepareMirrorTable(prepareLinearTable, width, x_gradient, from, to, 0.5);
     prepareMirrorTable(prepareLinearTable, height, y_gradient, from, to, 0.5);
 
-    size_t x;
-    size_t y;
-    size_t i;
-
-    for (i = 0, y = 0; y < height; ++y) {
-        for (x = 0; x < width; ++x, ++i) {
-
-            rgba[i].r = x_gradient[x].r + y_gradient[y].r;
-            rgba[i].g = x_gradient[x].g + y_gradient[y].g;
-            rgba[i].b = x_gradient[x].b + y_gradient[y].b;
-
-            pseudoInterlace(rgba[i], interlaced, y);
-        }
-    }
+    GradientRows rows(fillSumRows, interlaced, width, height, rgba, from, to, x_gradient, y_gradient);
+    renderRows(rows);
 }
 
 
@@ -418,31 +616,18 @@ void renderPyramidGradient(bool interlaced,
       .............
     .................
  */
-void renderRectangleGradient(bool interlaced,
-        unsigned int width, unsigned int height,
-        FbTk::RGBA* rgba,
-        const FbTk::Color* from, const FbTk::Color* to,
-        FbTk::ImageControl& imgctrl) {
-
-    const size_t s = width + height;
-
-    // we need 2 gradients but use only 'one' buffer
-    FbTk::RGBA* x_gradient = (FbTk::RGBA*)&getGradientBuffer(s * sizeof(FbTk::RGBA))[0];
-    FbTk::RGBA* y_gradient = x_gradient + width;
-
-    prepareMirrorTable(prepareLinearTable, width, x_gradient, from, to, 1.0);
-    prepareMirrorTable(prepareLinearTable, height, y_gradient, from, to, 1.0);
+void fillRectangleRows(const GradientRows& rows, size_t y_begin, size_t y_end) {
 
     // diagonal vectors
-    const Vec2 a = { static_cast<int>(width) - 1, static_cast<int>(height) - 1 };
+    const Vec2 a = { static_cast<int>(rows.width) - 1, static_cast<int>(rows.height) - 1 };
     const Vec2 b = { a.x, -a.y };
 
+    FbTk::RGBA* rgba = rows.rgba + (y_begin * rows.width);
     int x;
     int y;
-    size_t i;
 
-    for (i = 0, y = 0; y < static_cast<int>(height); ++y) {
-        for (x = 0; x < static_cast<int>(width); ++x, ++i) {
+    for (y = y_begin; y < static_cast<int>(y_end); ++y) {
+        for (x = 0; x < static_cast<int>(rows.width); ++x, ++rgba) {
 
             // check, if the point (x, y) is left or right of the vectors
             // 'a' and 'b'. if the point is on the same side for both 'a' and
@@ -450,23 +635,23 @@ void renderRectangleGradient(bool interlaced,
             // y_gradient, otherwise use x_gradient
 
             if (sign(a.cross(x, y)) * sign(b.cross(x, b.y + y)) < 0) {
-                rgba[i] = x_gradient[x];
+                *rgba = rows.x_gradient[x];
             } else {
-                rgba[i] = y_gradient[y];
+                *rgba = rows.y_gradient[y];
             }
 
-            pseudoInterlace(rgba[i], interlaced, y);
+            pseudoInterlace(*rgba, rows.interlaced, y);
         }
     }
 }
 
-void renderPipeCrossGradient(bool interlaced,
+void renderRectangleGradient(bool interlaced,
         unsigned int width, unsigned int height,
         FbTk::RGBA* rgba,
         const FbTk::Color* from, const FbTk::Color* to,
         FbTk::ImageControl& imgctrl) {
 
-    size_t s = width + height;
+    const size_t s = width + height;
 
     // we need 2 gradients but use only 'one' buffer
     FbTk::RGBA* x_gradient = (FbTk::RGBA*)&getGradientBuffer(s * sizeof(FbTk::RGBA))[0];
@@ -475,16 +660,22 @@ void renderPipeCrossGradient(bool interlaced,
     prepareMirrorTable(prepareLinearTable, width, x_gradient, from, to, 1.0);
     prepareMirrorTable(prepareLinearTable, height, y_gradient, from, to, 1.0);
 
+    GradientRows rows(fillRectangleRows, interlaced, width, height, rgba, from, to, x_gradient, y_gradient);
+    renderRows(rows);
+}
+
+void fillPipeCrossRows(const GradientRows& rows, size_t y_begin, size_t y_end) {
+
     // diagonal vectors
-    const Vec2 a = { static_cast<int>(width) - 1,  static_cast<int>(height - 1) };
+    const Vec2 a = { static_cast<int>(rows.width) - 1,  static_cast<int>(rows.height - 1) };
     const Vec2 b = { a.x, -a.y };
 
+    FbTk::RGBA* rgba = rows.rgba + (y_begin * rows.width);
     int x;
     int y;
-    size_t i;
 
-    for (i = 0, y = 0; y < static_cast<int>(height); ++y) {
-        for (x = 0; x < static_cast<int>(width); ++x, ++i) {
+    for (y = y_begin; y < static_cast<int>(y_end); ++y) {
+        for (x = 0; x < static_cast<int>(rows.width); ++x, ++rgba) {
 
             // check, if the point (x, y) is left or right of the vectors
             // 'a' and 'b'. if the point is on the same side for both 'a' and
@@ -492,16 +683,35 @@ void renderPipeCrossGradient(bool interlaced,
             // x_gradient, otherwise use y_gradient
 
             if (sign(a.cross(x, y)) * sign(b.cross(x, b.y + y)) > 0) {
-                rgba[i] = x_gradient[x];
+                *rgba = rows.x_gradient[x];
             } else {
-                rgba[i] = y_gradient[y];
+                *rgba = rows.y_gradient[y];
             }
 
-            pseudoInterlace(rgba[i], interlaced, y);
+            pseudoInterlace(*rgba, rows.interlaced, y);
         }
     }
 }
 
+void renderPipeCrossGradient(bool interlaced,
+        unsigned int width, unsigned int height,
+        FbTk::RGBA* rgba,
+        const FbTk::Color* from, const FbTk::Color* to,
+        FbTk::ImageControl& imgctrl) {
+
+    size_t s = width + height;
+
+    // we need 2 gradients but use only 'one' buffer
+    FbTk::RGBA* x_gradient = (FbTk::RGBA*)&getGradientBuffer(s * sizeof(FbTk::RGBA))[0];
+    FbTk::RGBA* y_gradient = x_gradient + width;
+
+    prepareMirrorTable(prepareLinearTable, width, x_gradient, from, to, 1.0);
+    prepareMirrorTable(prepareLinearTable, height, y_gradient, from, to, 1.0);
+
+    GradientRows rows(fillPipeCrossRows, interlaced, width, height, rgba, from, to, x_gradient, y_gradient);
+    renderRows(rows);
+}
+
 
 
 
@@ -522,69 +732,63 @@ void renderDiagonalGradient(bool interlaced,
     prepareLinearTable(width, x_gradient, from, to, 0.5);
     prepareLinearTable(height, y_gradient, from, to, 0.5);
 
-    size_t x;
-    size_t y;
-    size_t i;
-
-    for (i = 0, y = 0; y < height; ++y) {
-        for (x = 0; x < width; ++x, ++i) {
-
-            rgba[i].r = x_gradient[x].r + y_gradient[y].r;
-            rgba[i].g = x_gradient[x].g + y_gradient[y].g;
-            rgba[i].b = x_gradient[x].b + y_gradient[y].b;
-
-            pseudoInterlace(rgba[i], interlaced, y);
-        }
-    }
+    GradientRows rows(fillSumRows, interlaced, width, height, rgba, from, to, x_gradient, y_gradient);
+    renderRows(rows);
 }
 
 
 
 
-void renderEllipticGradient(bool interlaced,
-        unsigned int width, unsigned int height,
-        FbTk::RGBA* rgba,
-        const FbTk::Color* from, const FbTk::Color* to,
-        FbTk::ImageControl& imgctrl) {
+void fillEllipticRows(const GradientRows& rows, size_t y_begin, size_t y_end) {
 
-    const double r = to->red();
-    const double g = to->green();
-    const double b = to->blue();
+    const double r = rows.to->red();
+    const double g = rows.to->green();
+    const double b = rows.to->blue();
 
-    const double dr = r - from->red();
-    const double dg = g - from->green();
-    const double db = b - from->blue();
+    const double dr = r - rows.from->red();
+    const double dg = g - rows.from->green();
+    const double db = b - rows.from->blue();
 
-    const double w2 = width / 2.0;
-    const double h2 = height / 2.0;
+    const double w2 = rows.width / 2.0;
+    const double h2 = rows.height / 2.0;
 
     const double sw = 1.0 / (w2 * w2);
     const double sh = 1.0 / (h2 * h2);
 
-    size_t i;
+    FbTk::RGBA* rgba = rows.rgba + (y_begin * rows.width);
     int x;
     int y;
     double _x;
     double _y;
     double d;
 
-    for (i = 0, y = 0; y < static_cast<int>(height); ++y) {
-        for (x = 0; x < static_cast<int>(width); ++x, ++i) {
+    for (y = y_begin; y < static_cast<int>(y_end); ++y) {
+        for (x = 0; x < static_cast<int>(rows.width); ++x, ++rgba) {
 
             _x = x - w2;
             _y = y - h2;
 
             d = ((_x * _x * sw) + (_y * _y * sh)) / 2.0;
 
-            rgba[i].r = static_cast<unsigned char>(r - (d * dr));
-            rgba[i].g = static_cast<unsigned char>(g - (d * dg));
-            rgba[i].b = static_cast<unsigned char>(b - (d * db));
+            rgba->r = static_cast<unsigned char>(r - (d * dr));
+            rgba->g = static_cast<unsigned char>(g - (d * dg));
+            rgba->b = static_cast<unsigned char>(b - (d * db));
 
-            pseudoInterlace(rgba[i], interlaced, y);
+            pseudoInterlace(*rgba, rows.interlaced, y);
         }
     }
 }
 
+void renderEllipticGradient(bool interlaced,
+        unsigned int width, unsigned int height,
+        FbTk::RGBA* rgba,
+        const FbTk::Color* from, const FbTk::Color* to,
+        FbTk::ImageControl& imgctrl) {
+
+    GradientRows rows(fillEllipticRows, interlaced, width, height, rgba, from, to);
+    renderRows(rows);
+}
+
 
 
 
@@ -603,20 +807,8 @@ void renderCrossDiagonalGradient(bool interlaced,
     prepareLinearTable(width, x_gradient, to, from, 0.5);
     prepareLinearTable(height, y_gradient, from, to, 0.5);
 
-    size_t x;
-    size_t y;
-    size_t i;
-
-    for (i = 0, y = 0; y < height; ++y) {
-        for (x = 0; x < width; ++x, ++i) {
-
-            rgba[i].r = x_gradient[x].r + y_gradient[y].r;
-            rgba[i].g = x_gradient[x].g + y_gradient[y].g;
-            rgba[i].b = x_gradient[x].b + y_gradient[y].b;
-
-            pseudoInterlace(rgba[i], interlaced, y);
-        }
-    }
+    GradientRows rows(fillSumRows, interlaced, width, height, rgba, from, to, x_gradient, y_gradient);
+    renderRows(rows);
 }
 
 
@@ -689,6 +881,10 @@ TextureRender::~TextureRender() {
         delete[] rgba;
 }
 
+void TextureRender::setRenderThreads(unsigned int nr_threads) {
+    s_render_pool.setThreads(nr_threads);
+}
+
 
 Pixmap TextureRender::render(const FbTk::Texture &texture) {
 
@@ -855,10 +1051,7 @@ Pixmap TextureRender::renderPixmap(const FbTk::Texture &src_texture) {
 
 XImage *TextureRender::renderXImage() {
 
-    Display *disp = FbTk::App::instance()->display();
-    XImage *image = XCreateImage(disp,
-                     control.visual(), control.depth(), ZPixmap, 0, 0,
-                     width, height, 32, 0);
+    XImage *image = control.createImage(width, height);
 
     if (! image) {
         _FB_USES_NLS;
@@ -868,9 +1061,6 @@ XImage *TextureRender::renderXImage() {
         return 0;
     }
 
-    image->data = 0;
-
-
     const unsigned char *red_table;
     const unsigned char *green_table;
     const unsigned char *blue_table;
@@ -878,11 +1068,15 @@ XImage *TextureRender::renderXImage() {
     int green_offset;
     int blue_offset;
 
+    int red_bits;
+    int green_bits;
+    int blue_bits;
+
     control.colorTables(&red_table, &green_table, &blue_table,
                         &red_offset, &green_offset, &blue_offset,
-                        0, 0, 0);
+                        &red_bits, &green_bits, &blue_bits);
 
-    unsigned char *d = new unsigned char[image->bytes_per_line * (height + 1)];
+    unsigned char *d = reinterpret_cast<unsigned char *>(image->data);
     unsigned int x, y, r, g, b, offset;
 
     unsigned char *pixel_data = d, *ppixel_data = d;
@@ -914,6 +1108,13 @@ XImage *TextureRender::renderXImage() {
         break;
 
     case TrueColor:
+        // 8 bits per channel: the color tables are a no-op
+        if (o == 32 && red_bits == 1 && green_bits == 1 && blue_bits == 1) {
+            const PackedLayout layout = { red_offset, green_offset, blue_offset };
+            if (transferPacked32(rgba, width, height, d, image->bytes_per_line, layout))
+                break;
+        }
+
         switch (o) {
         case 8:
             TRANSFER_PIXELS((r << red_offset)|(g << green_offset)|(b << blue_offset),
@@ -970,14 +1171,12 @@ XImage *TextureRender::renderXImage() {
         _FB_USES_NLS;
         cerr << "TextureRender::renderXImage(): " <<
             _FBTK_CONSOLETEXT(Error, UnsupportedVisual, "Unsupported visual", "A visual is a technical term in X") << endl;
-        delete [] d;
-        XDestroyImage(image);
+        control.destroyImage(image);
         return (XImage *) 0;
     }
 
 #undef TRANSFER_PIXELS
 
-    image->data = (char *) d;
     return image;
 }
 
@@ -1000,20 +1199,11 @@ Pixmap TextureRender::renderPixmap() {
     if (! image) {
         return None;
     } else if (! image->data) {
-        XDestroyImage(image);
+        control.destroyImage(image);
         return None;
     }
 
-    XPutImage(disp, pixmap.drawable(),
-              DefaultGC(disp, control.screenNumber()),
-              image, 0, 0, 0, 0, width, height);
-
-    if (image->data != 0) {
-        delete [] image->data;
-        image->data = 0;
-    }
-
-    XDestroyImage(image);
+    control.putImage(pixmap.drawable(), image);
 
     pixmap.rotate(orientation);
 
@@ -53,6 +53,9 @@ public:
     Pixmap renderGradient(const FbTk::Texture &src_texture);
     /// scales and renders a pixmap
     Pixmap renderPixmap(const FbTk::Texture &src_texture);
+
+    /// number of threads used to render big gradients, 0 means one per cpu
+    static void setRenderThreads(unsigned int nr_threads);
 private:
     /// allocates red, green and blue for gradient rendering
     void allocateColorTables();
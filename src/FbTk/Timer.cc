@@ -26,6 +26,7 @@
 
 #include "CommandParser.hh"
 #include "StringUtil.hh"
+#include "LatencyStats.hh"
 
 #ifdef HAVE_CASSERT
   #include <cassert>
@@ -33,47 +34,145 @@
   #include <assert.h>
 #endif
 
-// sys/select.h on solaris wants to use memset()
-#ifdef HAVE_CSTRING
-#  include <cstring>
-#else
-#  include <string.h>
-#endif
-
-#ifdef HAVE_SYS_SELECT_H
-#  include <sys/select.h>
-#elif defined(_WIN32)
-#  include <winsock.h>
-#endif
-
 #include <cstdio>
 #include <vector>
-#include <set>
+#include <algorithm>
 
 namespace {
 
-struct TimerCompare {
-    // stable sort order and allows multiple timers to have
-    // the same end-time
-    bool operator() (const FbTk::Timer* a, const FbTk::Timer* b) const {
-        uint64_t ae = a->getEndTime();
-        uint64_t be = b->getEndTime();
-        return (ae < be) || (ae == be && a < b);
-    }
-};
-typedef std::set<FbTk::Timer*, TimerCompare> TimerList;
-TimerList s_timerlist;
+bool endsBefore(const FbTk::Timer *a, const FbTk::Timer *b) {
+    return a->getEndTime() < b->getEndTime();
+}
+
+uint64_t s_slack = 0; ///< how long a timeout may wait for a later one
 
 }
 
 
 namespace FbTk {
 
+/*
+ * 4-ary min-heap of the running timers, ordered by end time. Each timer
+ * knows its own position in the heap, so there is no searching to find
+ * out whether it runs or to stop it, and the heap storage is reused
+ * instead of allocating a node per start().
+ */
+class TimerQueue {
+public:
+    static const size_t NOT_QUEUED = static_cast<size_t>(-1);
+
+    static bool empty() { return s_heap.empty(); }
+    static const Timer &top() { return *s_heap.front(); }
+
+    static void push(Timer &timer) {
+        s_heap.push_back(&timer);
+        timer.m_queue_pos = s_heap.size() - 1;
+        siftUp(timer.m_queue_pos);
+    }
+
+    static void remove(Timer &timer) {
+        size_t pos = timer.m_queue_pos;
+        timer.m_queue_pos = NOT_QUEUED;
+
+        Timer *last = s_heap.back();
+        s_heap.pop_back();
+        if (last == &timer)
+            return;
+
+        place(last, pos);
+        if (pos > 0 && endsBefore(last, s_heap[parent(pos)]))
+            siftUp(pos);
+        else
+            siftDown(pos);
+    }
+
+    /// @return end time of the latest timer that ends within limit
+    static uint64_t latestBefore(uint64_t limit) {
+        uint64_t latest = 0;
+        if (!s_heap.empty())
+            latestBefore(0, limit, latest);
+        return latest;
+    }
+
+    /// adds all timers that end before (or at) limit to due, earliest first
+    static void collectDue(uint64_t limit, std::vector<Timer *> &due) {
+        if (!s_heap.empty())
+            collectDue(0, limit, due);
+        std::sort(due.begin(), due.end(), endsBefore);
+    }
+
+private:
+    static size_t parent(size_t pos) { return (pos - 1) / 4; }
+    static size_t firstChild(size_t pos) { return pos * 4 + 1; }
+
+    static void place(Timer *timer, size_t pos) {
+        s_heap[pos] = timer;
+        timer->m_queue_pos = pos;
+    }
+
+    static void siftUp(size_t pos) {
+        Timer *timer = s_heap[pos];
+        while (pos > 0 && endsBefore(timer, s_heap[parent(pos)])) {
+            place(s_heap[parent(pos)], pos);
+            pos = parent(pos);
+        }
+        place(timer, pos);
+    }
+
+    static void siftDown(size_t pos) {
+        Timer *timer = s_heap[pos];
+        const size_t size = s_heap.size();
+        for (;;) {
+            size_t child = firstChild(pos);
+            if (child >= size)
+                break;
+            size_t best = child;
+            size_t end = std::min(child + 4, size);
+            for (++child; child < end; ++child) {
+                if (endsBefore(s_heap[child], s_heap[best]))
+                    best = child;
+            }
+            if (!endsBefore(s_heap[best], timer))
+                break;
+            place(s_heap[best], pos);
+            pos = best;
+        }
+        place(timer, pos);
+    }
+
+    // the heap property lets us skip every subtree whose root ends too late
+    static void latestBefore(size_t pos, uint64_t limit, uint64_t &latest) {
+        uint64_t end_time = s_heap[pos]->getEndTime();
+        if (end_time > limit)
+            return;
+        latest = std::max(latest, end_time);
+        size_t child = firstChild(pos);
+        size_t end = std::min(child + 4, s_heap.size());
+        for (; child < end; ++child)
+            latestBefore(child, limit, latest);
+    }
+
+    static void collectDue(size_t pos, uint64_t limit, std::vector<Timer *> &due) {
+        if (s_heap[pos]->getEndTime() > limit)
+            return;
+        due.push_back(s_heap[pos]);
+        size_t child = firstChild(pos);
+        size_t end = std::min(child + 4, s_heap.size());
+        for (; child < end; ++child)
+            collectDue(child, limit, due);
+    }
+
+    static std::vector<Timer *> s_heap;
+};
+
+std::vector<Timer *> TimerQueue::s_heap;
+
 Timer::Timer() :
     m_once(false),
     m_interval(0),
     m_start(0),
-    m_timeout(0) {
+    m_timeout(0),
+    m_queue_pos(TimerQueue::NOT_QUEUED) {
 
 }
 
@@ -82,7 +181,8 @@ Timer::Timer(const RefCount<Slot<void> > &handler):
     m_once(false),
     m_interval(0),
     m_start(0),
-    m_timeout(0) {
+    m_timeout(0),
+    m_queue_pos(TimerQueue::NOT_QUEUED) {
 }
 
 
@@ -115,7 +215,7 @@ void Timer::start() {
 
         // in case start() gets triggered on a started 
         // timer with 'm_interval != 0' we have to remove
-        // it from s_timerlist before restarting it
+        // it from the queue before restarting it
         stop();
 
         m_start = FbTk::FbTime::mono();
@@ -125,13 +225,14 @@ void Timer::start() {
         if (m_interval != 0) {
             m_timeout = m_interval * FbTk::FbTime::IN_SECONDS;
         }
-        s_timerlist.insert(this);
+        TimerQueue::push(*this);
     }
 }
 
 
 void Timer::stop() {
-    s_timerlist.erase(this);
+    if (isTiming())
+        TimerQueue::remove(*this);
 }
 
 uint64_t Timer::getEndTime() const {
@@ -139,7 +240,7 @@ uint64_t Timer::getEndTime() const {
 }
 
 int Timer::isTiming() const {
-    return s_timerlist.find(const_cast<FbTk::Timer*>(this)) != s_timerlist.end();
+    return m_queue_pos != TimerQueue::NOT_QUEUED;
 }
 
 void Timer::fireTimeout() {
@@ -147,59 +248,40 @@ void Timer::fireTimeout() {
         (*m_handler)();
 }
 
+void Timer::setSlack(uint64_t slack) {
+    s_slack = slack;
+}
+
+uint64_t Timer::slack() {
+    return s_slack;
+}
 
-void Timer::updateTimers(int fd) {
 
-    fd_set              rfds;
-    timeval*            tout;
-    timeval             tm;
-    TimerList::iterator t;
-    bool                overdue = false;
-    uint64_t            now;
+bool Timer::nextWakeup(uint64_t &wakeup) {
 
+    if (TimerQueue::empty())
+        return false;
 
-    FD_ZERO(&rfds);
-    FD_SET(fd, &rfds);
-    tout = NULL;
+    wakeup = TimerQueue::top().getEndTime();
 
-    // search for overdue timers
-    if (!s_timerlist.empty()) {
+    // wake up late enough to also handle the timers which
+    // end shortly after the first one
+    if (wakeup > FbTime::mono())
+        wakeup = TimerQueue::latestBefore(wakeup + s_slack);
 
-        Timer*      timer = *s_timerlist.begin();
-        uint64_t    end_time = timer->getEndTime();
+    return true;
+}
 
-        now = FbTime::mono();
-        if (end_time <= now) {
-            overdue = true;
-        } else {
-            uint64_t    diff = (end_time - now);
-            tm.tv_sec = diff / FbTime::IN_SECONDS;
-            tm.tv_usec = diff % FbTime::IN_SECONDS;
-            tout = &tm;
-        }
-    }
 
-    // if not overdue, wait for the next xevent via the blocking
-    // select(), so OS sends fluxbox to sleep. the select() will
-    // time out when the next timer has to be handled
-    if (!overdue && select(fd + 1, &rfds, 0, 0, tout) != 0) {
-        // didn't time out! x events are pending
-        return;
-    }
+void Timer::handleTimeouts(uint64_t now) {
 
-    // stoping / restarting the timers modifies the list in an upredictable
+    // stoping / restarting the timers modifies the queue in an upredictable
     // way. to avoid problems (infinite loops etc) we copy the current overdue
-    // timers from the gloabl (and ordered) list of timers and work on it.
+    // timers from the queue and work on the copy.
 
     static std::vector<FbTk::Timer*> timeouts;
 
-    now = FbTime::mono();
-    for (t = s_timerlist.begin(); t != s_timerlist.end(); ++t ) {
-        if (now < (*t)->getEndTime()) {
-            break;
-        }
-        timeouts.push_back(*t);
-    }
+    TimerQueue::collectDue(now, timeouts);
 
     size_t i;
     const size_t ts = timeouts.size();
@@ -207,13 +289,24 @@ void Timer::updateTimers(int fd) {
 
         FbTk::Timer& timer = *timeouts[i];
 
+        // an earlier handler might have stopped or restarted it
+        if (!timer.isTiming() || timer.getEndTime() > now)
+            continue;
+
         // first we stop the timer to remove it
-        // from s_timerlist
+        // from the queue
         timer.stop();
 
         // then we call the handler which might (re)start 't'
         // on it's own
-        timer.fireTimeout();
+        if (LatencyStats::enabled() && timer.m_handler) {
+            std::string name = "timer " + LatencyStats::typeName(typeid(*timer.m_handler));
+            uint64_t start = FbTime::mono();
+            timer.fireTimeout();
+            LatencyStats::add(name, start);
+        } else {
+            timer.fireTimeout();
+        }
 
         // restart 't' if needed
         if (!timer.doOnce() && !timer.isTiming()) {
@@ -33,6 +33,8 @@
 
 namespace FbTk {
 
+class TimerQueue;
+
 /**
     Handles Timeout
 */
@@ -55,7 +57,22 @@ public:
     void start();
     void stop();
 
-    static void updateTimers(int file_descriptor);
+    /**
+       Tells when the running timers have to be handled next.
+       @param wakeup set to the monotonic time (see FbTime::mono()) to wake
+              up at, in the past if a timer is overdue
+       @return false if no timer runs
+    */
+    static bool nextWakeup(uint64_t &wakeup);
+    /// handles all timers which end at or before now
+    static void handleTimeouts(uint64_t now);
+
+    /**
+       Sets how long (in microseconds) a timeout may be delayed so it can be
+       handled in the same wake-up as a later one. Timers never fire early.
+    */
+    static void setSlack(uint64_t slack);
+    static uint64_t slack();
 
     int isTiming() const;
     int getInterval() const { return m_interval; }
@@ -71,6 +88,8 @@ protected:
     void fireTimeout();
 
 private:
+    friend class TimerQueue;
+
     RefCount<Slot<void> > m_handler; ///< what to do on a timeout
 
     bool m_once;  ///< do timeout only once?
@@ -78,6 +97,8 @@ private:
 
     uint64_t m_start;   ///< start time in microseconds
     uint64_t m_timeout; ///< time length in microseconds
+
+    size_t m_queue_pos; ///< position in the queue of running timers
 };
 
 
@@ -0,0 +1,152 @@
+// WindowMap.hh for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FBTK_WINDOWMAP_HH
+#define FBTK_WINDOWMAP_HH
+
+#include <X11/Xlib.h>
+
+#include <vector>
+#include <cstdlib> // size_t
+
+namespace FbTk {
+
+/**
+   Maps windows to pointers in one flat array with linear probing.
+   None is the empty slot, so it can't be a key. Removing moves the
+   following entries of the probe run back instead of leaving tombstones,
+   and the last window found is remembered, since events tend to come in
+   runs for the same window (motion, expose).
+*/
+template <typename T>
+class WindowMap {
+public:
+    WindowMap(): m_size(0), m_last_win(None), m_last_value(0) {
+        m_slots.resize(MIN_SLOTS);
+    }
+
+    /// @return value for win or 0 if there is none
+    T *find(Window win) const {
+        if (win == None)
+            return 0;
+        if (win == m_last_win)
+            return m_last_value;
+
+        for (size_t i = slot(win); m_slots[i].win != None; i = next(i)) {
+            if (m_slots[i].win == win) {
+                m_last_win = win;
+                m_last_value = m_slots[i].value;
+                return m_last_value;
+            }
+        }
+        return 0;
+    }
+
+    /// sets the value for win, replacing any older one
+    void insert(Window win, T *value) {
+        if (win == None)
+            return;
+        if ((m_size + 1) * 4 > m_slots.size() * 3)
+            rehash(m_slots.size() * 2);
+
+        size_t i = slot(win);
+        for (; m_slots[i].win != None; i = next(i)) {
+            if (m_slots[i].win == win)
+                break;
+        }
+        if (m_slots[i].win == None)
+            ++m_size;
+        m_slots[i].win = win;
+        m_slots[i].value = value;
+        if (m_last_win == win)
+            m_last_value = value;
+    }
+
+    void erase(Window win) {
+        if (win == None)
+            return;
+        if (m_last_win == win)
+            m_last_win = None;
+
+        size_t i = slot(win);
+        for (; m_slots[i].win != win; i = next(i)) {
+            if (m_slots[i].win == None)
+                return;
+        }
+
+        // pull back every later entry of the run which may go in the hole
+        size_t hole = i;
+        for (i = next(i); m_slots[i].win != None; i = next(i)) {
+            size_t home = slot(m_slots[i].win);
+            // the entry can move if its home isn't in (hole, i]
+            if ((i > hole && (home <= hole || home > i)) ||
+                (i < hole && (home <= hole && home > i))) {
+                m_slots[hole] = m_slots[i];
+                hole = i;
+            }
+        }
+        m_slots[hole].win = None;
+        m_slots[hole].value = 0;
+        --m_size;
+
+        if (m_slots.size() > MIN_SLOTS && m_size * 8 < m_slots.size())
+            rehash(m_slots.size() / 2);
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    enum { MIN_SLOTS = 64 };
+
+    struct Slot {
+        Slot(): win(None), value(0) { }
+        Window win;
+        T *value;
+    };
+
+    // xids of one client only differ in the low bits, so spread them
+    // with a multiplication and fold the upper bits back before masking
+    size_t slot(Window win) const {
+        unsigned long hash = static_cast<unsigned long>(win) * 2654435761UL;
+        return (hash ^ (hash >> 15)) & (m_slots.size() - 1);
+    }
+    size_t next(size_t i) const { return (i + 1) & (m_slots.size() - 1); }
+
+    void rehash(size_t nr_slots) {
+        std::vector<Slot> old(nr_slots);
+        old.swap(m_slots);
+        m_size = 0;
+        for (size_t i = 0; i < old.size(); ++i) {
+            if (old[i].win != None)
+                insert(old[i].win, old[i].value);
+        }
+    }
+
+    std::vector<Slot> m_slots; ///< size is a power of two
+    size_t m_size;
+    mutable Window m_last_win;
+    mutable T *m_last_value;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_WINDOWMAP_HH
@@ -0,0 +1,219 @@
+// WorkerPool.cc for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#include "WorkerPool.hh"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif // HAVE_UNISTD_H
+
+#ifdef HAVE_PTHREAD
+#include <signal.h>
+#endif // HAVE_PTHREAD
+
+#include <algorithm>
+
+namespace {
+
+unsigned int nrCpus() {
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0)
+        return static_cast<unsigned int>(n);
+#endif
+    return 1;
+}
+
+} // end anonymous namespace
+
+namespace FbTk {
+
+WorkerPool::WorkerPool():
+    m_nr_threads(1),
+    m_job(0),
+    m_size(0),
+    m_band(0),
+    m_next(0),
+    m_pending(0),
+    m_generation(0),
+    m_quit(false) {
+
+#ifdef HAVE_PTHREAD
+    pthread_mutex_init(&m_mutex, 0);
+    pthread_cond_init(&m_wakeup, 0);
+    pthread_cond_init(&m_done, 0);
+#endif // HAVE_PTHREAD
+}
+
+WorkerPool::~WorkerPool() {
+    stopThreads();
+#ifdef HAVE_PTHREAD
+    pthread_cond_destroy(&m_done);
+    pthread_cond_destroy(&m_wakeup);
+    pthread_mutex_destroy(&m_mutex);
+#endif // HAVE_PTHREAD
+}
+
+void WorkerPool::setThreads(unsigned int nr_threads) {
+
+    if (nr_threads == 0)
+        nr_threads = nrCpus();
+
+#ifdef HAVE_PTHREAD
+    if (nr_threads == m_nr_threads)
+        return;
+
+    stopThreads();
+
+    // signals should be delivered to the main thread only, the workers
+    // inherit the blocked mask
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    // the calling thread is the first worker
+    for (unsigned int i = 1; i < nr_threads; ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, 0, threadMain, this) != 0)
+            break;
+        m_threads.push_back(thread);
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, 0);
+
+    m_nr_threads = m_threads.size() + 1;
+#endif // HAVE_PTHREAD
+}
+
+void WorkerPool::run(Job &job, size_t size, size_t min_band) {
+
+    if (size == 0)
+        return;
+
+    min_band = std::max(min_band, static_cast<size_t>(1));
+
+#ifdef HAVE_PTHREAD
+    if (m_threads.empty() || size < 2 * min_band) {
+        job.run(0, size);
+        return;
+    }
+
+    // a few bands per thread to even out bands of different cost
+    size_t nr_bands = std::min(static_cast<size_t>(m_nr_threads) * 4, size / min_band);
+    size_t band = (size + nr_bands - 1) / nr_bands;
+
+    pthread_mutex_lock(&m_mutex);
+    m_job = &job;
+    m_size = size;
+    m_band = band;
+    m_next = 0;
+    m_pending = (size + band - 1) / band;
+    m_generation++;
+    pthread_cond_broadcast(&m_wakeup);
+    pthread_mutex_unlock(&m_mutex);
+
+    while (runBand())
+        ;
+
+    pthread_mutex_lock(&m_mutex);
+    while (m_pending > 0)
+        pthread_cond_wait(&m_done, &m_mutex);
+    m_job = 0;
+    pthread_mutex_unlock(&m_mutex);
+#else
+    job.run(0, size);
+#endif // HAVE_PTHREAD
+}
+
+bool WorkerPool::runBand() {
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&m_mutex);
+    if (m_job == 0 || m_next >= m_size) {
+        pthread_mutex_unlock(&m_mutex);
+        return false;
+    }
+
+    Job *job = m_job;
+    size_t begin = m_next;
+    size_t end = std::min(begin + m_band, m_size);
+    m_next = end;
+    pthread_mutex_unlock(&m_mutex);
+
+    job->run(begin, end);
+
+    pthread_mutex_lock(&m_mutex);
+    if (--m_pending == 0)
+        pthread_cond_signal(&m_done);
+    pthread_mutex_unlock(&m_mutex);
+
+    return true;
+#else
+    return false;
+#endif // HAVE_PTHREAD
+}
+
+void WorkerPool::stopThreads() {
+#ifdef HAVE_PTHREAD
+    if (m_threads.empty())
+        return;
+
+    pthread_mutex_lock(&m_mutex);
+    m_quit = true;
+    pthread_cond_broadcast(&m_wakeup);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        pthread_join(m_threads[i], 0);
+
+    m_threads.clear();
+    m_nr_threads = 1;
+    m_quit = false;
+#endif // HAVE_PTHREAD
+}
+
+void *WorkerPool::threadMain(void *data) {
+#ifdef HAVE_PTHREAD
+    WorkerPool *pool = static_cast<WorkerPool *>(data);
+
+    pthread_mutex_lock(&pool->m_mutex);
+    unsigned long generation = pool->m_generation;
+    while (true) {
+        while (!pool->m_quit && pool->m_generation == generation)
+            pthread_cond_wait(&pool->m_wakeup, &pool->m_mutex);
+
+        if (pool->m_quit)
+            break;
+
+        generation = pool->m_generation;
+        pthread_mutex_unlock(&pool->m_mutex);
+
+        while (pool->runBand())
+            ;
+
+        pthread_mutex_lock(&pool->m_mutex);
+    }
+    pthread_mutex_unlock(&pool->m_mutex);
+#endif // HAVE_PTHREAD
+    return 0;
+}
+
+} // end namespace FbTk
@@ -0,0 +1,95 @@
+// WorkerPool.hh for FbTk - Fluxbox Toolkit
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+#ifndef FBTK_WORKERPOOL_HH
+#define FBTK_WORKERPOOL_HH
+
+#include "NotCopyable.hh"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif // HAVE_PTHREAD
+
+#include <vector>
+#include <cstddef>
+
+namespace FbTk {
+
+/**
+   A small pool of threads to split cpu bound work (like rendering
+   textures) into bands. Jobs must not touch the X connection or any
+   other shared state, they only get a range of the work to do.
+   Without thread support (or with 1 thread) the job is run directly.
+*/
+class WorkerPool: private NotCopyable {
+public:
+
+    /// a piece of work which can be split into independent parts
+    class Job {
+    public:
+        virtual ~Job() { }
+        /// process the parts [begin, end)
+        virtual void run(size_t begin, size_t end) = 0;
+    };
+
+    WorkerPool();
+    ~WorkerPool();
+
+    /// number of threads to use, including the calling one. 0 means one per cpu
+    void setThreads(unsigned int nr_threads);
+
+    /**
+       Runs 'job' over [0, size), split into bands of at least 'min_band'
+       parts. The calling thread works on the bands as well and the call
+       returns when all of them are done.
+    */
+    void run(Job &job, size_t size, size_t min_band = 1);
+
+    unsigned int threads() const { return m_nr_threads; }
+
+private:
+    static void *threadMain(void *pool);
+    void stopThreads();
+    /// takes the next band of the current job and runs it, false if there was none
+    bool runBand();
+
+    unsigned int m_nr_threads;
+
+#ifdef HAVE_PTHREAD
+    std::vector<pthread_t> m_threads;
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_wakeup; ///< signaled when a job arrives or the pool stops
+    pthread_cond_t m_done;   ///< signaled when the last band is finished
+#endif // HAVE_PTHREAD
+
+    Job *m_job;
+    size_t m_size;      ///< size of the current job
+    size_t m_band;      ///< size of each band
+    size_t m_next;      ///< start of the next unclaimed band
+    size_t m_pending;   ///< bands not finished yet
+    unsigned long m_generation; ///< counts the jobs, wakes up the threads
+    bool m_quit;
+};
+
+} // end namespace FbTk
+
+#endif // FBTK_WORKERPOOL_HH
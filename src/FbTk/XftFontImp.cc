@@ -26,9 +26,123 @@
 #include <cmath>
 #include <cstdio>
 #include <algorithm>
+#include <list>
+#include <map>
 
 namespace FbTk {
 
+namespace {
+
+/// XftDraws kept around for the most recently drawn on drawables
+struct DrawCacheItem {
+    Drawable drawable;
+    int screen;
+    XftDraw *draw;
+};
+
+typedef std::list<DrawCacheItem> DrawCache;
+/// XftColors keyed on (screen, pixel value) of the GC foreground
+typedef std::map<std::pair<int, unsigned long>, XftColor> ColorCache;
+
+const size_t DRAW_CACHE_MAX = 32;
+const size_t COLOR_CACHE_MAX = 64;
+
+DrawCache s_draw_cache; // most recently used first
+ColorCache s_color_cache;
+unsigned int s_instances = 0;
+
+void freeColors(Display *disp) {
+    ColorCache::iterator it = s_color_cache.begin();
+    for (; it != s_color_cache.end(); ++it) {
+        int screen = it->first.first;
+        XftColorFree(disp, DefaultVisual(disp, screen),
+                     DefaultColormap(disp, screen), &it->second);
+    }
+    s_color_cache.clear();
+}
+
+void freeDraws() {
+    DrawCache::iterator it = s_draw_cache.begin();
+    for (; it != s_draw_cache.end(); ++it)
+        XftDrawDestroy(it->draw);
+    s_draw_cache.clear();
+}
+
+/// drops the XftDraw of a drawable before the drawable goes away
+void drawableDestroyed(Drawable drawable) {
+    DrawCache::iterator it = s_draw_cache.begin();
+    for (; it != s_draw_cache.end(); ++it) {
+        if (it->drawable == drawable) {
+            XftDrawDestroy(it->draw);
+            s_draw_cache.erase(it);
+            return;
+        }
+    }
+}
+
+XftDraw *getDraw(Display *disp, Drawable drawable, int screen) {
+
+    DrawCache::iterator it = s_draw_cache.begin();
+    for (; it != s_draw_cache.end(); ++it) {
+        if (it->drawable == drawable && it->screen == screen) {
+            if (it != s_draw_cache.begin())
+                s_draw_cache.splice(s_draw_cache.begin(), s_draw_cache, it);
+            return it->draw;
+        }
+    }
+
+    DrawCacheItem item;
+    item.drawable = drawable;
+    item.screen = screen;
+    item.draw = XftDrawCreate(disp, drawable,
+                              DefaultVisual(disp, screen),
+                              DefaultColormap(disp, screen));
+    if (item.draw == 0)
+        return 0;
+
+    if (s_draw_cache.size() >= DRAW_CACHE_MAX) {
+        XftDrawDestroy(s_draw_cache.back().draw);
+        s_draw_cache.pop_back();
+    }
+    s_draw_cache.push_front(item);
+    return item.draw;
+}
+
+const XftColor *getColor(Display *disp, int screen, unsigned long pixel) {
+
+    std::pair<int, unsigned long> key(screen, pixel);
+    ColorCache::iterator it = s_color_cache.find(key);
+    if (it != s_color_cache.end())
+        return &it->second;
+
+    Visual *visual = DefaultVisual(disp, screen);
+    Colormap colmap = DefaultColormap(disp, screen);
+
+    // get red, green, blue values
+    XColor xcol;
+    xcol.pixel = pixel;
+    XQueryColor(disp, colmap, &xcol);
+
+    // convert xcolor to XftColor
+    XRenderColor rendcol;
+    rendcol.red = xcol.red;
+    rendcol.green = xcol.green;
+    rendcol.blue = xcol.blue;
+    rendcol.alpha = 0xFFFF;
+    XftColor xftcolor;
+    if (!XftColorAllocValue(disp, visual, colmap, &rendcol, &xftcolor))
+        return 0;
+
+    // themes only use a handful of text colors, so when we overflow
+    // something odd is going on and we simply start over
+    if (s_color_cache.size() >= COLOR_CACHE_MAX)
+        freeColors(disp);
+
+    return &(s_color_cache[key] = xftcolor);
+}
+
+} // end anonymous namespace
+
 XftFontImp::XftFontImp(const char *name, bool utf8):
     m_utf8mode(utf8), m_name(""), m_maxlength(0x8000) {
 
@@ -37,6 +151,9 @@ XftFontImp::XftFontImp(const char *name, bool utf8):
         m_xftfonts_loaded[r] = false;
     }
 
+    if (s_instances++ == 0)
+        FbDrawable::addDestroyHook(drawableDestroyed);
+
     if (name != 0)
         load(name);
 }
@@ -45,6 +162,12 @@ XftFontImp::~XftFontImp() {
     for (int r = ROT0; r <= ROT270; r++) 
         if (m_xftfonts[r] != 0)
             XftFontClose(App::instance()->display(), m_xftfonts[r]);
+
+    // the draw and color caches are shared by all xft fonts
+    if (--s_instances == 0) {
+        freeDraws();
+        freeColors(App::instance()->display());
+    }
 }
 
 bool XftFontImp::load(const std::string &name) {
@@ -108,53 +231,35 @@ void XftFontImp::drawText(const FbDrawable &w, int screen, GC gc, const char* te
         break;
     }
 
-    Visual* def_visual = DefaultVisual(w.display(), screen);
-    Colormap def_colmap = DefaultColormap(w.display(), screen);
-
     XftFont *font = m_xftfonts[orient];
-    XftDraw *draw = XftDrawCreate(w.display(), w.drawable(), def_visual, def_colmap);
+    XftDraw *draw = getDraw(w.display(), w.drawable(), screen);
+    if (draw == 0)
+        return;
 
+    // get foreground pixel value, the gc values are cached by xlib
+    // so this does not cost a round trip
     XGCValues gc_val;
+    if (!XGetGCValues(w.display(), gc, GCForeground, &gc_val))
+        return;
 
-    // get foreground pixel value and convert it to XRenderColor value
-    // TODO: we should probably check return status
-    XGetGCValues(w.display(), gc, GCForeground, &gc_val);
-
-    // get red, green, blue values
-    XColor xcol;
-    xcol.pixel = gc_val.foreground;
-    XQueryColor(w.display(), def_colmap, &xcol);
-
-    // convert xcolor to XftColor
-    XRenderColor rendcol;
-    rendcol.red = xcol.red;
-    rendcol.green = xcol.green;
-    rendcol.blue = xcol.blue;
-    rendcol.alpha = 0xFFFF;
-    XftColor xftcolor;
-    XftColorAllocValue(w.display(), def_visual, def_colmap, &rendcol, &xftcolor);
+    const XftColor *xftcolor = getColor(w.display(), screen, gc_val.foreground);
+    if (xftcolor == 0)
+        return;
 
     // draw string
 #ifdef HAVE_XFT_UTF8_STRING
     if (m_utf8mode) {
-        // check the string size,
-        // if the size is zero we use the XftDrawString8 function instead.
-        XGlyphInfo ginfo;
-        XftTextExtentsUtf8(w.display(), m_xftfonts[ROT0], (XftChar8 *)text, len, &ginfo);
-        if (ginfo.xOff != 0) {
-            XftDrawStringUtf8(draw, &xftcolor, font, x, y, (XftChar8 *)text, len);
-            XftColorFree(w.display(), def_visual, def_colmap, &xftcolor);
-            XftDrawDestroy(draw);
+        // if the string is not valid utf8 we use the XftDrawString8
+        // function instead.
+        int nchar, wchar;
+        if (FcUtf8Len((FcChar8 *)text, len, &nchar, &wchar)) {
+            XftDrawStringUtf8(draw, xftcolor, font, x, y, (XftChar8 *)text, len);
             return;
         }
     }
 #endif // HAVE_XFT_UTF8_STRING
 
-    XftDrawString8(draw, &xftcolor, font, x, y, (XftChar8 *)text, len);
-
-
-    XftColorFree(w.display(), def_visual, def_colmap, &xftcolor);
-    XftDrawDestroy(draw);
+    XftDrawString8(draw, xftcolor, font, x, y, (XftChar8 *)text, len);
 }
 
 unsigned int XftFontImp::textWidth(const char* text, unsigned int len) const {
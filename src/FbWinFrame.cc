@@ -95,6 +95,15 @@ void render(FbTk::Color &col, Pixmap &pm, unsigned int width, unsigned int heigh
 
 }
 
+/// gives pixmaps back to the image cache
+void release(Pixmap *pm, size_t count, FbTk::ImageControl& ictl) {
+    for (size_t i = 0; i < count; ++i) {
+        if (pm[i])
+            ictl.removeImage(pm[i]);
+        pm[i] = None;
+    }
+}
+
 void bg_pm_or_color(FbTk::FbWindow& win, const Pixmap& pm, const FbTk::Color& color) {
     if (pm) {
         win.setBackgroundPixmap(pm);
@@ -145,6 +154,7 @@ FbWinFrame::FbWinFrame(BScreen &screen, unsigned int client_depth,
     m_tabmode(screen.getDefaultInternalTabs()?INTERNAL:EXTERNAL),
     m_active_orig_client_bw(0),
     m_need_render(true),
+    m_prerendering(false),
     m_button_size(1),
     m_shape(m_window, theme->shapePlace()) {
 
@@ -154,6 +164,15 @@ FbWinFrame::FbWinFrame(BScreen &screen, unsigned int client_depth,
 FbWinFrame::~FbWinFrame() {
     removeEventHandler();
     removeAllButtons();
+
+    // the pixmaps are shared with all frames of the same size through
+    // the image cache, so it has to know when nobody uses them anymore
+    release(m_title_face.pm, 2, m_imagectrl);
+    release(m_label_face.pm, 2, m_imagectrl);
+    release(m_tabcontainer_face.pm, 2, m_imagectrl);
+    release(m_handle_face.pm, 2, m_imagectrl);
+    release(m_grip_face.pm, 2, m_imagectrl);
+    release(m_button_face.pm, 3, m_imagectrl);
 }
 
 bool FbWinFrame::setTabMode(TabMode tabmode) {
@@ -216,6 +235,8 @@ bool FbWinFrame::setTabMode(TabMode tabmode) {
         m_label.hide();
     }
 
+    m_geometry_sig.emit();
+
     return ret;
 }
 
@@ -243,6 +264,17 @@ void FbWinFrame::show() {
     m_window.show();
 }
 
+bool FbWinFrame::prerender() {
+    if (isVisible() || !m_need_render)
+        return false;
+
+    m_prerendering = true;
+    renderAll();
+    m_prerendering = false;
+    applyAll();
+    return true;
+}
+
 void FbWinFrame::move(int x, int y) {
     moveResize(x, y, 0, 0, true, false);
 }
@@ -311,6 +343,8 @@ void FbWinFrame::moveResize(int x, int y, unsigned int width, unsigned int heigh
         }
         reconfigure();
     }
+
+    m_geometry_sig.emit();
 }
 
 void FbWinFrame::quietMoveResize(int x, int y,
@@ -326,6 +360,8 @@ void FbWinFrame::quietMoveResize(int x, int y,
         m_tab_container.setMaxTotalSize(s);
         alignTabs();
     }
+
+    m_geometry_sig.emit();
 }
 
 void FbWinFrame::alignTabs() {
@@ -395,6 +431,8 @@ void FbWinFrame::alignTabs() {
     } else {
         tabs.move(tab_x, tab_y);
     }
+
+    m_geometry_sig.emit();
 }
 
 void FbWinFrame::notifyMoved(bool clear) {
@@ -951,6 +989,8 @@ void FbWinFrame::reconfigure() {
     m_shape.setPlaces(getShape());
     m_shape.setShapeOffsets(0, titlebarHeight());
 
+    m_geometry_sig.emit();
+
     // titlebar stuff rendered already by reconftitlebar
 }
 
@@ -1066,14 +1106,20 @@ void FbWinFrame::applyAll() {
     applyTabContainer();
 }
 
+bool FbWinFrame::deferRender() {
+    if (isVisible() || m_prerendering)
+        return false;
+
+    m_need_render = true;
+    return true;
+}
+
 void FbWinFrame::renderTitlebar() {
     if (!m_use_titlebar)
         return;
 
-    if (!isVisible()) {
-        m_need_render = true;
+    if (deferRender())
         return;
-    }
 
     typedef FbTk::ThemeProxy<FbWinFrameTheme> TP;
     TP& ft = theme().focusedTheme();
@@ -1096,10 +1142,8 @@ void FbWinFrame::renderTitlebar() {
 }
 
 void FbWinFrame::renderTabContainer() {
-    if (!isVisible()) {
-        m_need_render = true;
+    if (deferRender())
         return;
-    }
 
     typedef FbTk::ThemeProxy<FbWinFrameTheme> TP;
     TP& ft = theme().focusedTheme();
@@ -1146,10 +1190,8 @@ void FbWinFrame::renderHandles() {
     if (!m_use_handle)
         return;
 
-    if (!isVisible()) {
-        m_need_render = true;
+    if (deferRender())
         return;
-    }
 
     typedef FbTk::ThemeProxy<FbWinFrameTheme> TP;
     TP& ft = theme().focusedTheme();
@@ -1189,10 +1231,8 @@ void FbWinFrame::applyHandles() {
 
 void FbWinFrame::renderButtons() {
 
-    if (!isVisible()) {
-        m_need_render = true;
+    if (deferRender())
         return;
-    }
 
     typedef FbTk::ThemeProxy<FbWinFrameTheme> TP;
     TP& ft = theme().focusedTheme();
@@ -1359,6 +1399,8 @@ void FbWinFrame::applyDecorations(bool do_move) {
     }
     if (client_move)
         frameExtentSig().emit();
+
+    m_geometry_sig.emit();
 }
 
 bool FbWinFrame::setBorderWidth(bool do_move) {
@@ -1418,6 +1460,8 @@ bool FbWinFrame::setBorderWidth(bool do_move) {
             move(grav_x + x(), grav_y + y());
     }
 
+    m_geometry_sig.emit();
+
     return true;
 }
 
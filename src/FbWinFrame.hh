@@ -78,6 +78,12 @@ public:
     void hide();
     void show();
     bool isVisible() const { return m_visible; }
+    /**
+       Renders the decorations of a hidden frame now instead of when it
+       is shown next.
+       @return true if there was anything to render
+    */
+    bool prerender();
 
     void move(int x, int y);
     void resize(unsigned int width, unsigned int height);
@@ -225,6 +231,8 @@ public:
     FbTk::LayerItem &layerItem() { return m_layeritem; }
 
     FbTk::Signal<> &frameExtentSig() { return m_frame_extent_sig; }
+    /// emitted when the frame or its external tabs might have moved or changed size
+    FbTk::Signal<> &geometrySig() { return m_geometry_sig; }
     /// @returns true if the window is inside titlebar, 
     /// assuming window is an event window that was generated for this frame.
     bool insideTitlebar(Window win) const;
@@ -251,6 +259,9 @@ private:
 
     void renderButtons(); // subset of renderTitlebar - don't call directly
 
+    /// @return true if rendering has to wait until the frame is shown
+    bool deferRender();
+
     //@}
 
     // these return true/false for if something changed
@@ -313,6 +324,7 @@ private:
     //@}
 
     FbTk::Signal<> m_frame_extent_sig;
+    FbTk::Signal<> m_geometry_sig;
 
     typedef std::vector<FbTk::Button *> ButtonList;
     ButtonList m_buttons_left, ///< buttons to the left
@@ -349,6 +361,7 @@ private:
     unsigned int m_active_orig_client_bw;
 
     bool m_need_render;
+    bool m_prerendering; ///< rendering although hidden
     int m_button_size; ///< size for all titlebar buttons
     int m_alpha[2]; // 0-unfocused, 1-focused
 
@@ -35,6 +35,7 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <limits>
 #ifdef HAVE_CSTRING
   #include <cstring>
 #else
@@ -337,84 +338,109 @@ void FocusControl::dirFocus(FluxboxWindow &win, FocusDir dir) {
         left = win.x() + borderW,
         right = win.x() + win.width() + borderW;
 
-    Workspace::Windows &wins = m_screen.currentWorkspace()->windowList();
-    Workspace::Windows::iterator it = wins.begin();
-    for (; it != wins.end(); ++it) {
-        if ((*it) == &win
-            || (*it)->isIconic()
-            || (*it)->isFocusHidden()
-            || !(*it)->acceptsFocus())
-            continue; // skip self
-
-        // we check things against an edge, and within the bounds (draw a picture)
-        int edge=0, upper=0, lower=0, oedge=0, oupper=0, olower=0;
-
-        int otop = (*it)->y() + borderW,
-            // 2 * border = border on each side
-            obottom = (*it)->y() + (*it)->height() + borderW,
-            oleft = (*it)->x() + borderW,
-            // 2 * border = border on each side
-            oright = (*it)->x() + (*it)->width() + borderW;
-
-        // check if they intersect
-        switch (dir) {
-        case FOCUSUP:
-            edge = obottom;
-            oedge = bottom;
-            upper = left;
-            oupper = oleft;
-            lower = right;
-            olower = oright;
-            break;
-        case FOCUSDOWN:
-            edge = top;
-            oedge = otop;
-            upper = left;
-            oupper = oleft;
-            lower = right;
-            olower = oright;
-            break;
-        case FOCUSLEFT:
-            edge = oright;
-            oedge = right;
-            upper = top;
-            oupper = otop;
-            lower = bottom;
-            olower = obottom;
-            break;
-        case FOCUSRIGHT:
-            edge = left;
-            oedge = oleft;
-            upper = top;
-            oupper = otop;
-            lower = bottom;
-            olower = obottom;
-            break;
-        }
-
-        if (oedge < edge)
-            continue; // not in the right direction
+    // a window overlapping us in the given direction always beats the
+    // others, so first ask the index for the windows in that beam. only if
+    // there is none, all windows are candidates
+    const int far_away = std::numeric_limits<int>::max();
+    int beam_left = left, beam_top = top, beam_right = right, beam_bottom = bottom;
+    switch (dir) {
+    case FOCUSUP:    beam_top = -far_away;   break;
+    case FOCUSDOWN:  beam_bottom = far_away; break;
+    case FOCUSLEFT:  beam_left = -far_away;  break;
+    case FOCUSRIGHT: beam_right = far_away;  break;
+    }
 
-        if (olower <= upper || oupper >= lower) {
-            // outside our horz bounds, get a heavy weight penalty
-            int myweight = 100000 + oedge - edge + abs(upper-oupper)+abs(lower-olower);
-            if (myweight < weight) {
-                foundwin = *it;
-                exposure = 0;
-                weight = myweight;
+    Workspace &workspace = *m_screen.currentWorkspace();
+    FrameIndex::Windows wins;
+    m_screen.frameIndex().find(workspace, beam_left, beam_top,
+                               beam_right, beam_bottom, wins);
+
+    for (int pass = 0; pass < 2 && !foundwin; ++pass) {
+
+        if (pass == 1)
+            wins.assign(workspace.windowList().begin(), workspace.windowList().end());
+
+        FrameIndex::Windows::iterator it = wins.begin();
+        for (; it != wins.end(); ++it) {
+            if ((*it) == &win
+                || (*it)->isIconic()
+                || (*it)->isFocusHidden()
+                || !(*it)->acceptsFocus())
+                continue; // skip self
+
+            // we check things against an edge, and within the bounds (draw a picture)
+            int edge=0, upper=0, lower=0, oedge=0, oupper=0, olower=0;
+
+            int otop = (*it)->y() + borderW,
+                // 2 * border = border on each side
+                obottom = (*it)->y() + (*it)->height() + borderW,
+                oleft = (*it)->x() + borderW,
+                // 2 * border = border on each side
+                oright = (*it)->x() + (*it)->width() + borderW;
+
+            // check if they intersect
+            switch (dir) {
+            case FOCUSUP:
+                edge = obottom;
+                oedge = bottom;
+                upper = left;
+                oupper = oleft;
+                lower = right;
+                olower = oright;
+                break;
+            case FOCUSDOWN:
+                edge = top;
+                oedge = otop;
+                upper = left;
+                oupper = oleft;
+                lower = right;
+                olower = oright;
+                break;
+            case FOCUSLEFT:
+                edge = oright;
+                oedge = right;
+                upper = top;
+                oupper = otop;
+                lower = bottom;
+                olower = obottom;
+                break;
+            case FOCUSRIGHT:
+                edge = left;
+                oedge = oleft;
+                upper = top;
+                oupper = otop;
+                lower = bottom;
+                olower = obottom;
+                break;
             }
-        } else if ((oedge - edge) < weight) {
-            foundwin = *it;
-            weight = oedge - edge;
-            exposure = ((lower < olower)?lower:olower) - ((upper > oupper)?upper:oupper);
-        } else if (foundwin && oedge - edge == weight) {
-            int myexp = ((lower < olower)?lower:olower) - ((upper > oupper)?upper:oupper);
-            if (myexp > exposure) {
+
+            if (oedge < edge)
+                continue; // not in the right direction
+
+            if (olower <= upper || oupper >= lower) {
+                if (pass == 0)
+                    continue; // only the beam in the first pass
+                // outside our horz bounds, get a heavy weight penalty
+                int myweight = 100000 + oedge - edge + abs(upper-oupper)+abs(lower-olower);
+                if (myweight < weight) {
+                    foundwin = *it;
+                    exposure = 0;
+                    weight = myweight;
+                }
+            } else if ((oedge - edge) < weight) {
                 foundwin = *it;
-                // weight is same
-                exposure = myexp;
-            }
-        } // else not improvement
+                weight = oedge - edge;
+                exposure = ((lower < olower)?lower:olower) - ((upper > oupper)?upper:oupper);
+            } else if (foundwin && oedge - edge == weight) {
+                int myexp = ((lower < olower)?lower:olower) - ((upper > oupper)?upper:oupper);
+                if (myexp > exposure) {
+                    foundwin = *it;
+                    // weight is same
+                    exposure = myexp;
+                }
+            } // else not improvement
+        }
+
     }
 
     if (foundwin)
@@ -0,0 +1,163 @@
+// FrameIndex.cc for Fluxbox
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "FrameIndex.hh"
+
+#include <algorithm>
+
+namespace {
+
+// a frame usually covers a handful of cells
+const int CELL_SIZE = 256;
+
+int cell(int pos) {
+    return pos >= 0 ? pos / CELL_SIZE : -1 - (-(pos + 1)) / CELL_SIZE;
+}
+
+}
+
+FrameIndex::FrameIndex():
+    m_serial(0) {
+}
+
+FrameIndex::Cells FrameIndex::cellsOf(int left, int top, int right, int bottom) {
+    Cells cells;
+    cells.left = cell(left);
+    cells.top = cell(top);
+    cells.right = cell(right);
+    cells.bottom = cell(bottom);
+    return cells;
+}
+
+void FrameIndex::add(FluxboxWindow &win, const Workspace &workspace,
+                     int left, int top, int right, int bottom) {
+
+    remove(win);
+
+    Entry entry;
+    entry.workspace = &workspace;
+    entry.serial = m_serial++;
+    entry.cells = cellsOf(left, top, right, bottom);
+
+    m_entries[&win] = entry;
+    insert(win, entry);
+}
+
+void FrameIndex::remove(FluxboxWindow &win) {
+
+    Entries::iterator it = m_entries.find(&win);
+    if (it == m_entries.end())
+        return;
+
+    erase(win, it->second);
+    m_entries.erase(it);
+}
+
+void FrameIndex::update(FluxboxWindow &win, int left, int top,
+                        int right, int bottom) {
+
+    Entries::iterator it = m_entries.find(&win);
+    if (it == m_entries.end())
+        return;
+
+    Cells cells = cellsOf(left, top, right, bottom);
+    if (cells == it->second.cells)
+        return;
+
+    erase(win, it->second);
+    it->second.cells = cells;
+    insert(win, it->second);
+}
+
+void FrameIndex::insert(FluxboxWindow &win, const Entry &entry) {
+
+    WorkspaceGrid &ws = m_grids[entry.workspace];
+    if (ws.grid.empty()) {
+        ws.extent = entry.cells;
+    } else {
+        ws.extent.left = std::min(ws.extent.left, entry.cells.left);
+        ws.extent.top = std::min(ws.extent.top, entry.cells.top);
+        ws.extent.right = std::max(ws.extent.right, entry.cells.right);
+        ws.extent.bottom = std::max(ws.extent.bottom, entry.cells.bottom);
+    }
+
+    for (int x = entry.cells.left; x <= entry.cells.right; ++x) {
+        for (int y = entry.cells.top; y <= entry.cells.bottom; ++y)
+            ws.grid[std::make_pair(x, y)].push_back(Item(entry.serial, &win));
+    }
+}
+
+void FrameIndex::erase(FluxboxWindow &win, const Entry &entry) {
+
+    Grids::iterator ws = m_grids.find(entry.workspace);
+    if (ws == m_grids.end())
+        return;
+
+    Grid &grid = ws->second.grid;
+    for (int x = entry.cells.left; x <= entry.cells.right; ++x) {
+        for (int y = entry.cells.top; y <= entry.cells.bottom; ++y) {
+            Grid::iterator c = grid.find(std::make_pair(x, y));
+            if (c == grid.end())
+                continue;
+            Items &items = c->second;
+            items.erase(std::remove(items.begin(), items.end(), Item(entry.serial, &win)),
+                        items.end());
+            if (items.empty())
+                grid.erase(c);
+        }
+    }
+
+    if (grid.empty())
+        m_grids.erase(ws);
+}
+
+void FrameIndex::find(const Workspace &workspace, int left, int top,
+                      int right, int bottom, Windows &result) const {
+
+    result.clear();
+
+    Grids::const_iterator ws = m_grids.find(&workspace);
+    if (ws == m_grids.end())
+        return;
+
+    const Cells &extent = ws->second.extent;
+    int cl = std::max(cell(left), extent.left);
+    int ct = std::max(cell(top), extent.top);
+    int cr = std::min(cell(right), extent.right);
+    int cb = std::min(cell(bottom), extent.bottom);
+
+    const Grid &grid = ws->second.grid;
+    Items found;
+    for (int x = cl; x <= cr; ++x) {
+        for (int y = ct; y <= cb; ++y) {
+            Grid::const_iterator c = grid.find(std::make_pair(x, y));
+            if (c != grid.end())
+                found.insert(found.end(), c->second.begin(), c->second.end());
+        }
+    }
+
+    // windows covering several cells were found several times
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    for (size_t i = 0; i < found.size(); ++i)
+        result.push_back(found[i].second);
+}
@@ -0,0 +1,102 @@
+// FrameIndex.hh for Fluxbox
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FRAMEINDEX_HH
+#define FRAMEINDEX_HH
+
+#include "FbTk/NotCopyable.hh"
+
+#include <map>
+#include <vector>
+#include <utility>
+
+class FluxboxWindow;
+class Workspace;
+
+/**
+ * Spatial index of the window frames (with their external tabs) of each
+ * workspace of a screen, a uniform grid of cells which list the windows
+ * touching them. Lets edge snapping and directional focus look at the
+ * windows near a place instead of all windows of the workspace.
+ * Workspace keeps the members in sync, FluxboxWindow reports changes
+ * of its frame bounds. The windows themselves are never looked at.
+ */
+class FrameIndex: private FbTk::NotCopyable {
+public:
+    typedef std::vector<FluxboxWindow *> Windows;
+
+    FrameIndex();
+
+    /**
+     * Indexes win as window of workspace, after all windows added before.
+     * The frame of win covers [left, right] x [top, bottom].
+     */
+    void add(FluxboxWindow &win, const Workspace &workspace,
+             int left, int top, int right, int bottom);
+    void remove(FluxboxWindow &win);
+    /// the frame of win moved to [left, right] x [top, bottom]
+    void update(FluxboxWindow &win, int left, int top, int right, int bottom);
+
+    /**
+     * Finds the windows of workspace whose frame might intersect the
+     * rectangle [left, right] x [top, bottom], in the order they were added.
+     * The result can hold windows which just miss the rectangle.
+     */
+    void find(const Workspace &workspace, int left, int top, int right, int bottom,
+              Windows &result) const;
+
+private:
+    struct Cells {
+        int left, top, right, bottom; // inclusive cell numbers
+        bool operator == (const Cells &other) const {
+            return left == other.left && top == other.top &&
+                right == other.right && bottom == other.bottom;
+        }
+    };
+
+    struct Entry {
+        const Workspace *workspace;
+        unsigned long serial; ///< order of adding
+        Cells cells;
+    };
+
+    typedef std::pair<unsigned long, FluxboxWindow *> Item;
+    typedef std::vector<Item> Items;
+    typedef std::map<std::pair<int, int>, Items> Grid;
+
+    struct WorkspaceGrid {
+        Grid grid;
+        Cells extent; ///< cells ever used, to clip open ended searches
+    };
+
+    static Cells cellsOf(int left, int top, int right, int bottom);
+    void insert(FluxboxWindow &win, const Entry &entry);
+    void erase(FluxboxWindow &win, const Entry &entry);
+
+    typedef std::map<FluxboxWindow *, Entry> Entries;
+    typedef std::map<const Workspace *, WorkspaceGrid> Grids;
+
+    Entries m_entries;
+    Grids m_grids;
+    unsigned long m_serial;
+};
+
+#endif // FRAMEINDEX_HH
@@ -0,0 +1,196 @@
+// FreeSpace.cc for Fluxbox
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "FreeSpace.hh"
+
+#include <algorithm>
+#include <utility>
+
+using std::vector;
+using std::pair;
+using std::make_pair;
+using std::min;
+using std::max;
+using std::swap;
+
+FreeSpace::FreeSpace(int left, int top, int right, int bottom,
+                     bool rows, bool left_right, bool top_bot):
+    m_rows(rows), m_left_right(left_right), m_top_bot(top_bot) {
+
+    m_head = toSearch(left, top, right, bottom);
+}
+
+void FreeSpace::add(int left, int top, int right, int bottom) {
+    if (left < right && top < bottom)
+        m_rects.push_back(toSearch(left, top, right, bottom));
+}
+
+FreeSpace::Rect FreeSpace::toSearch(int left, int top, int right, int bottom) const {
+    Rect rect = { left, top, right, bottom };
+    if (!m_left_right) {
+        rect.left = -right;
+        rect.right = -left;
+    }
+    if (!m_top_bot) {
+        rect.top = -bottom;
+        rect.bottom = -top;
+    }
+    if (!m_rows) {
+        swap(rect.left, rect.top);
+        swap(rect.right, rect.bottom);
+    }
+    return rect;
+}
+
+void FreeSpace::fromSearch(int search_x, int search_y, int width, int height,
+                           int &x, int &y) const {
+    if (!m_rows)
+        swap(search_x, search_y);
+    x = m_left_right ? search_x : -(search_x + width);
+    y = m_top_bot ? search_y : -(search_y + height);
+}
+
+bool FreeSpace::firstFit(int width, int height, int &x, int &y) const {
+
+    const int w = m_rows ? width : height;
+    const int h = m_rows ? height : width;
+
+    if (m_head.left + w > m_head.right || m_head.top + h > m_head.bottom)
+        return false;
+
+    // a position covered by a window stays covered up to the right edge
+    // of that window, and the whole row stays covered until the first of
+    // the windows in the way ends, so jump there
+    int top = m_head.top;
+    while (top + h <= m_head.bottom) {
+        int next_top = m_head.bottom;
+        int left = m_head.left;
+        while (left + w <= m_head.right) {
+            vector<Rect>::const_iterator it = m_rects.begin(), it_end = m_rects.end();
+            for (; it != it_end; ++it) {
+                if (it->left < left + w && it->right > left &&
+                    it->top < top + h && it->bottom > top)
+                    break;
+            }
+            if (it == it_end) {
+                fromSearch(left, top, width, height, x, y);
+                return true;
+            }
+            left = it->right;
+            next_top = min(next_top, it->bottom);
+        }
+        top = next_top;
+    }
+
+    return false;
+}
+
+int64_t FreeSpace::leastOverlap(int width, int height, int &x, int &y) const {
+
+    if (firstFit(width, height, x, y))
+        return 0;
+
+    const int w = m_rows ? width : height;
+    const int h = m_rows ? height : width;
+    const int max_left = max(m_head.left, m_head.right - w);
+    const int max_top = max(m_head.top, m_head.bottom - h);
+
+    // between the edges of the windows the covered area changes linearly,
+    // so the least one is found where the new window touches the head or
+    // lines up with an edge of another window
+    vector<int> rows;
+    rows.push_back(m_head.top);
+    rows.push_back(max_top);
+    vector<Rect>::const_iterator it = m_rects.begin(), it_end = m_rects.end();
+    for (; it != it_end; ++it) {
+        if (it->bottom > m_head.top && it->bottom < max_top)
+            rows.push_back(it->bottom);
+        if (it->top - h > m_head.top && it->top - h < max_top)
+            rows.push_back(it->top - h);
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    int64_t best = -1;
+    int best_left = m_head.left, best_top = m_head.top;
+
+    // changes of the slope of the covered area along the row
+    vector<pair<int, int64_t> > changes;
+    for (size_t row = 0; row < rows.size(); ++row) {
+        const int top = rows[row];
+
+        changes.clear();
+        int64_t area = 0, slope = 0;
+        for (it = m_rects.begin(); it != it_end; ++it) {
+            const int64_t covered_h = min(it->bottom, top + h) - max(it->top, top);
+            if (covered_h <= 0)
+                continue;
+
+            const int covered_w = min(it->right, m_head.left + w) - max(it->left, m_head.left);
+            if (covered_w > 0)
+                area += covered_h * covered_w;
+
+            // the covered width grows from zero, stays at its widest while
+            // one window holds the other and shrinks back to zero
+            const pair<int, int64_t> edges[] = {
+                make_pair(it->left - w, covered_h),
+                make_pair(min(it->left, it->right - w), -covered_h),
+                make_pair(max(it->left, it->right - w), -covered_h),
+                make_pair(it->right, covered_h)
+            };
+            for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+                if (edges[i].first <= m_head.left)
+                    slope += edges[i].second;
+                else if (edges[i].first <= max_left)
+                    changes.push_back(edges[i]);
+            }
+        }
+        std::sort(changes.begin(), changes.end());
+
+        int left = m_head.left;
+        if (best < 0 || area < best) {
+            best = area;
+            best_left = left;
+            best_top = top;
+        }
+
+        for (size_t i = 0; i < changes.size(); ++i) {
+            area += slope * (changes[i].first - left);
+            left = changes[i].first;
+            slope += changes[i].second;
+            if (area < best) {
+                best = area;
+                best_left = left;
+                best_top = top;
+            }
+        }
+
+        area += slope * (max_left - left);
+        if (area < best) {
+            best = area;
+            best_left = max_left;
+            best_top = top;
+        }
+    }
+
+    fromSearch(best_left, best_top, width, height, x, y);
+    return best;
+}
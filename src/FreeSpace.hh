@@ -0,0 +1,83 @@
+// FreeSpace.hh for Fluxbox
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#ifndef FREESPACE_HH
+#define FREESPACE_HH
+
+#include <vector>
+#include <cstddef>
+#include <inttypes.h>
+
+/**
+ * Finds room for a new window among the windows on a head, for the smart
+ * placement strategies. Positions are searched row by row or column by
+ * column, starting at the corner given by the row and column directions;
+ * internally everything is mirrored and transposed so the search always
+ * runs left to right through rows from the top.
+ * Rectangles are half open: right and bottom are the first pixels outside.
+ */
+class FreeSpace {
+public:
+    /**
+     * @param rows fill rows first (true) or columns first (false)
+     * @param left_right rows are filled from the left
+     * @param top_bot columns are filled from the top
+     */
+    FreeSpace(int left, int top, int right, int bottom,
+              bool rows, bool left_right, bool top_bot);
+
+    /// adds a window which should not be covered
+    void add(int left, int top, int right, int bottom);
+    void clear() { m_rects.clear(); }
+    std::size_t size() const { return m_rects.size(); }
+
+    /**
+     * Finds the first position, in search order, where a width x height
+     * window fits on the head without covering any other window.
+     * @return false if there is no such position
+     */
+    bool firstFit(int width, int height, int &x, int &y) const;
+
+    /**
+     * Finds the position where a width x height window covers the least
+     * area of the other windows, the first one in search order if several
+     * are equally good.
+     * @return the covered area
+     */
+    int64_t leastOverlap(int width, int height, int &x, int &y) const;
+
+private:
+    struct Rect {
+        int left, top, right, bottom;
+    };
+
+    /// converts a rectangle to search coordinates
+    Rect toSearch(int left, int top, int right, int bottom) const;
+    /// converts the position of a window in search coordinates back
+    void fromSearch(int search_x, int search_y, int width, int height,
+                    int &x, int &y) const;
+
+    Rect m_head; ///< in search coordinates
+    bool m_rows, m_left_right, m_top_bot;
+    std::vector<Rect> m_rects; ///< the windows, in search coordinates
+};
+
+#endif // FREESPACE_HH
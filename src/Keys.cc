@@ -146,17 +146,45 @@ public:
                 int context_, bool isdouble_) {
         // t_key ctor sets context_ of 0 to GLOBAL, so we must here too
         context_ = context_ ? context_ : GLOBAL;
-        keylist_t::iterator it = keylist.begin(), it_end = keylist.end();
-        for (; it != it_end; ++it) {
-            if (*it && (*it)->type == type_ && (*it)->key == key_ &&
-                ((*it)->context & context_) > 0 &&
-                isdouble_ == (*it)->isdouble && (*it)->mod ==
-                FbTk::KeyUtil::instance().isolateModifierMask(mod_))
-                return *it;
+        mod_ = FbTk::KeyUtil::instance().isolateModifierMask(mod_);
+        int i = first(type_, mod_, key_, context_);
+        for (; i >= 0; i = m_next[i]) {
+            const RefKey &k = m_indexed[i];
+            if (k->type == type_ && k->key == key_ && k->mod == mod_ &&
+                (k->context & context_) > 0 && isdouble_ == k->isdouble)
+                return k;
         }
         return RefKey();
     }
 
+    /// like find(), but a double click falls back to a single click binding
+    RefKey findEvent(int type_, unsigned int mod_, unsigned int key_,
+                     int context_, bool isdouble_) {
+        context_ = context_ ? context_ : GLOBAL;
+        mod_ = FbTk::KeyUtil::instance().isolateModifierMask(mod_);
+        int single = -1;
+        int i = first(type_, mod_, key_, context_);
+        for (; i >= 0; i = m_next[i]) {
+            const RefKey &k = m_indexed[i];
+            if (k->type != type_ || k->key != key_ || k->mod != mod_ ||
+                (k->context & context_) == 0)
+                continue;
+            if (isdouble_ == k->isdouble)
+                return k;
+            if (single < 0 && !k->isdouble)
+                single = i;
+        }
+        return single < 0 ? RefKey() : m_indexed[single];
+    }
+
+    void add(const RefKey &k) {
+        keylist.push_back(k);
+        m_index_valid = false;
+    }
+
+    /// the keys of the children changed, e.g. after a keymap change
+    void invalidateIndex() { m_index_valid = false; }
+
     // member variables
 
     int type; // KeyPress or ButtonPress
@@ -168,6 +196,32 @@ public:
     FbTk::RefCount<FbTk::Command<void> > m_command;
 
     keylist_t keylist;
+
+private:
+    static size_t hash(int type_, unsigned int mod_, unsigned int key_) {
+        size_t h = type_;
+        h = h * 31 + mod_;
+        h = h * 31 + key_;
+        return h ^ (h >> 16);
+    }
+
+    /// @return index of the first child in the bucket of the binding or -1
+    int first(int type_, unsigned int mod_, unsigned int key_, int context_) {
+        if (!m_index_valid)
+            buildIndex();
+        if ((m_contexts & context_) == 0)
+            return -1;
+        return m_buckets[hash(type_, mod_, key_) & (m_buckets.size() - 1)];
+    }
+
+    void buildIndex();
+
+    // hash index over keylist, chained through m_next in keylist order
+    bool m_index_valid;
+    int m_contexts; ///< all contexts of the children
+    std::vector<RefKey> m_indexed;
+    std::vector<int> m_next;
+    std::vector<int> m_buckets; ///< size is a power of two
 };
 
 Keys::t_key::t_key(int type_, unsigned int mod_, unsigned int key_,
@@ -179,11 +233,36 @@ Keys::t_key::t_key(int type_, unsigned int mod_, unsigned int key_,
     key_str(key_str_),
     context(context_),
     isdouble(isdouble_),
-    m_command(0) {
+    m_command(0),
+    m_index_valid(false),
+    m_contexts(0) {
 
     context = context_ ? context_ : GLOBAL;
 }
 
+void Keys::t_key::buildIndex() {
+    size_t nr_buckets = 8;
+    while (nr_buckets < keylist.size() * 2)
+        nr_buckets *= 2;
+
+    m_indexed.assign(keylist.begin(), keylist.end());
+    m_next.assign(m_indexed.size(), -1);
+    m_buckets.assign(nr_buckets, -1);
+    m_contexts = 0;
+
+    // add them backwards, so each bucket is in keylist order
+    for (int i = static_cast<int>(m_indexed.size()) - 1; i >= 0; --i) {
+        const RefKey &k = m_indexed[i];
+        if (!k)
+            continue;
+        int &bucket = m_buckets[hash(k->type, k->mod, k->key) & (nr_buckets - 1)];
+        m_next[i] = bucket;
+        bucket = i;
+        m_contexts |= k->context;
+    }
+    m_index_valid = true;
+}
+
 
 Keys::Keys():
     m_reloader(new FbTk::AutoReloadHelper()),
@@ -485,7 +564,7 @@ bool Keys::addBinding(const string &linebuffer) {
                 } else {
                     RefKey temp_key( new t_key(type, mod, key, key_str, context,
                                                 isdouble) );
-                    current_key->keylist.push_back(temp_key);
+                    current_key->add(temp_key);
                     current_key = temp_key;
                 }
                 mod = 0;
@@ -507,7 +586,7 @@ bool Keys::addBinding(const string &linebuffer) {
                 return false;
 
             // success
-            first_new_keylist->keylist.push_back(first_new_key);
+            first_new_keylist->add(first_new_key);
             return true;
         }  // end if
     } // end for
@@ -548,12 +627,9 @@ bool Keys::doAction(int type, unsigned int mods, unsigned int key,
         next_key = m_keylist;
 
     mods = FbTk::KeyUtil::instance().cleanMods(mods);
-    RefKey temp_key = next_key->find(type, mods, key, context, isdouble);
-
     // just because we double-clicked doesn't mean we shouldn't look for single
     // click commands
-    if (!temp_key && isdouble)
-        temp_key = next_key->find(type, mods, key, context, false);
+    RefKey temp_key = next_key->findEvent(type, mods, key, context, isdouble);
 
     if (temp_key && !temp_key->keylist.empty()) { // emacs-style
         if (!saved_keymode)
@@ -656,6 +732,7 @@ void Keys::setKeyMode(const FbTk::RefCount<t_key> &keyMode) {
             grabButton(t->key, t->mod, t->context);
         }
     }
+    keyMode->invalidateIndex();
     m_keylist = keyMode;
 }
 
@@ -0,0 +1,55 @@
+// PlacementStrategy.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+#include "PlacementStrategy.hh"
+
+#include "FreeSpace.hh"
+#include "FocusControl.hh"
+#include "Screen.hh"
+#include "Window.hh"
+
+void PlacementStrategy::addWindows(const FluxboxWindow &win, bool same_layer,
+                                   FreeSpace &space) {
+
+    const std::list<Focusable *> &focusables =
+            win.screen().focusControl().focusedOrderWinList().clientList();
+    std::list<Focusable *>::const_iterator foc_it = focusables.begin(),
+                                           foc_it_end = focusables.end();
+    unsigned int workspace = win.workspaceNumber();
+    for (; foc_it != foc_it_end; ++foc_it) {
+        // make sure it's a FluxboxWindow
+        FluxboxWindow *fbwin = (*foc_it)->fbwindow();
+        if (*foc_it != fbwin || fbwin == &win)
+            continue;
+        if (workspace != fbwin->workspaceNumber() && !fbwin->isStuck())
+            continue;
+        if (same_layer && fbwin->layerNum() != win.layerNum())
+            continue;
+
+        // minus offset to get back up to fake place
+        int left = fbwin->x() - fbwin->xOffset();
+        int top = fbwin->y() - fbwin->yOffset();
+        int bw = 2 * fbwin->fbWindow().borderWidth();
+        space.add(left, top,
+                  left + fbwin->width() + bw + fbwin->widthOffset(),
+                  top + fbwin->height() + bw + fbwin->heightOffset());
+    }
+}
@@ -23,6 +23,7 @@
 #define PLACEMENTSTRATEGY_HH
 
 class FluxboxWindow;
+class FreeSpace;
 
 struct PlacementStrategy {
     /**
@@ -36,6 +37,14 @@ struct PlacementStrategy {
                              int &place_x, int &place_y) = 0;
 
     virtual ~PlacementStrategy() { }
+
+protected:
+    /**
+     * Adds the windows on the workspace of @win, and the stuck ones, to @space
+     * @param same_layer only add the windows in the layer of @win
+     */
+    static void addWindows(const FluxboxWindow &win, bool same_layer,
+                           FreeSpace &space);
 };
 
 #endif // PLACEMENTSTRATEGY_HH
@@ -44,9 +44,12 @@
 #include "FbTk/AutoReloadHelper.hh"
 #include "FbTk/RefCount.hh"
 #include "FbTk/Util.hh"
+#include "FbTk/FbTime.hh"
 
 #include <cstring>
 #include <set>
+#include <vector>
+#include <algorithm>
 
 
 using std::cerr;
@@ -632,11 +635,134 @@ Application* findMatchingPatterns(ClientPattern *pat, Remember::Patterns *patlis
 /*------------------------------------------------------------------*\
 \*------------------------------------------------------------------*/
 
+/**
+ * Buckets the patterns of the apps file by the literal prefix of their
+ * class (or else name) term, so a new window only runs the full regex
+ * match against patterns that can possibly match its WM_CLASS. Patterns
+ * without such a prefix are always candidates. Candidates are tried in
+ * apps file order, so the first match is the same as without the index.
+ */
+class RememberIndex {
+public:
+    void rebuild(Remember::Patterns &pats);
+    void add(Remember::Patterns::iterator it);
+    /// @return the first pattern that matches winclient, or 0
+    const std::pair<ClientPattern *, Application *> *find(WinClient &winclient);
+    string report() const;
+
+private:
+    struct Entry {
+        Remember::Patterns::iterator it;
+        unsigned long evaluations;
+        unsigned long matches;
+        uint64_t usec;
+    };
+    typedef std::vector<size_t> Positions;
+    typedef std::map<string, Positions> Buckets;
+
+    void collect(const Buckets &buckets, const string &value, Positions &out) const;
+
+    std::vector<Entry> m_entries; // in apps file order
+    Buckets m_classes;
+    Buckets m_names;
+    Positions m_unindexed;
+};
+
+void RememberIndex::rebuild(Remember::Patterns &pats) {
+    m_entries.clear();
+    m_classes.clear();
+    m_names.clear();
+    m_unindexed.clear();
+
+    Remember::Patterns::iterator it = pats.begin();
+    for (; it != pats.end(); ++it)
+        add(it);
+}
+
+void RememberIndex::add(Remember::Patterns::iterator it) {
+
+    Entry entry;
+    entry.it = it;
+    entry.evaluations = entry.matches = 0;
+    entry.usec = 0;
+    m_entries.push_back(entry);
+
+    size_t pos = m_entries.size() - 1;
+    string prefix;
+    if (it->first->literalPrefix(ClientPattern::CLASS, prefix))
+        m_classes[prefix].push_back(pos);
+    else if (it->first->literalPrefix(ClientPattern::NAME, prefix))
+        m_names[prefix].push_back(pos);
+    else
+        m_unindexed.push_back(pos);
+}
+
+// adds the positions of all buckets whose key is a prefix of value
+void RememberIndex::collect(const Buckets &buckets, const string &value, Positions &out) const {
+    if (buckets.empty() || value.empty())
+        return;
+
+    string key;
+    for (size_t len = 1; len <= value.size(); ++len) {
+        key.assign(value, 0, len);
+        Buckets::const_iterator it = buckets.find(key);
+        if (it != buckets.end())
+            out.insert(out.end(), it->second.begin(), it->second.end());
+    }
+}
+
+const std::pair<ClientPattern *, Application *> *RememberIndex::find(WinClient &winclient) {
+
+    Positions candidates(m_unindexed);
+    collect(m_classes, ClientPattern::getProperty(ClientPattern::CLASS, winclient), candidates);
+    collect(m_names, ClientPattern::getProperty(ClientPattern::NAME, winclient), candidates);
+    std::sort(candidates.begin(), candidates.end());
+
+    bool transient = winclient.isTransient();
+    Positions::iterator it = candidates.begin();
+    for (; it != candidates.end(); ++it) {
+        Entry &entry = m_entries[*it];
+        if (entry.it->second->is_transient != transient)
+            continue;
+
+        uint64_t start = FbTk::FbTime::mono();
+        bool match = entry.it->first->match(winclient);
+        entry.usec += FbTk::FbTime::mono() - start;
+        entry.evaluations++;
+
+        if (match) {
+            entry.matches++;
+            return &(*entry.it);
+        }
+    }
+    return 0;
+}
+
+string RememberIndex::report() const {
+
+    std::vector<std::pair<uint64_t, size_t> > order;
+    for (size_t i = 0; i < m_entries.size(); ++i)
+        order.push_back(make_pair(m_entries[i].usec, i));
+    std::sort(order.rbegin(), order.rend());
+
+    FbTk_ostringstream out;
+    out << m_entries.size() << " patterns, "
+        << (m_entries.size() - m_unindexed.size()) << " indexed" << endl;
+    out << "usec\tevals\tmatches\tpattern" << endl;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Entry &entry = m_entries[order[i].second];
+        out << entry.usec << "\t" << entry.evaluations << "\t"
+            << entry.matches << "\t" << entry.it->first->toString() << endl;
+    }
+    return out.str();
+}
+
 Remember *Remember::s_instance = 0;
 
 Remember::Remember():
     m_pats(new Patterns()),
-    m_reloader(new FbTk::AutoReloadHelper()) {
+    m_reloader(new FbTk::AutoReloadHelper()),
+    m_index(new RememberIndex()) {
 
     setName("remember");
 
@@ -671,6 +797,7 @@ Remember::~Remember() {
     }
 
     delete(m_reloader);
+    delete m_index;
 
     s_instance = 0;
 }
@@ -682,14 +809,12 @@ Application* Remember::find(WinClient &winclient) {
     if (wc_it != m_clients.end())
         return wc_it->second;
     else {
-        Patterns::iterator it = m_pats->begin();
-        for (; it != m_pats->end(); ++it)
-            if (it->first->match(winclient) &&
-                it->second->is_transient == winclient.isTransient()) {
-                it->first->addMatch();
-                m_clients[&winclient] = it->second;
-                return it->second;
-            }
+        const std::pair<ClientPattern *, Application *> *match = m_index->find(winclient);
+        if (match) {
+            match->first->addMatch();
+            m_clients[&winclient] = match->second;
+            return match->second;
+        }
     }
     // oh well, no matches
     return 0;
@@ -711,6 +836,7 @@ Application * Remember::add(WinClient &winclient) {
     m_clients[&winclient] = app;
     p->addMatch();
     m_pats->push_back(make_pair(p, app));
+    m_index->add(--m_pats->end());
     return app;
 }
 
@@ -868,6 +994,12 @@ void Remember::reload() {
     }
 
     delete old_pats;
+
+    m_index->rebuild(*m_pats);
+}
+
+string Remember::matchCostReport() const {
+    return m_index->report();
 }
 
 void Remember::save() {
@@ -38,6 +38,7 @@ class FluxboxWindow;
 class BScreen;
 class WinClient;
 class Application;
+class RememberIndex;
 
 namespace FbTk {
 class AutoReloadHelper;
@@ -128,6 +129,9 @@ public:
 
     static FbTk::Menu* createMenu(BScreen& screen);
 
+    /// @return how much time matching spent in each pattern, slowest first
+    std::string matchCostReport() const;
+
     // Functions we ignore (zero from AtomHandler)
     // Leaving here in case they might be useful later
 
@@ -162,6 +166,7 @@ private:
     static Remember *s_instance;
 
     FbTk::AutoReloadHelper* m_reloader;
+    RememberIndex* m_index; ///< m_pats bucketed by literal class/name prefixes
 };
 
 #endif // REMEMBER_HH
@@ -195,6 +195,7 @@ BScreen::BScreen(FbTk::ResourceManager &rm,
     root_colormap_installed(false),
     m_image_control(0),
     m_current_workspace(0),
+    m_former_workspace(0),
     m_focused_windowtheme(new FbWinFrameTheme(scrn, ".focus", ".Focus")),
     m_unfocused_windowtheme(new FbWinFrameTheme(scrn, ".unfocus", ".Unfocus")),
     // the order of windowtheme and winbutton theme is important
@@ -216,7 +217,8 @@ BScreen::BScreen(FbTk::ResourceManager &rm,
     m_focus_control(new FocusControl(*this)),
     m_placement_strategy(new ScreenPlacement(*this)),
     m_cycle_opts(0),
-    m_opts(opts) {
+    m_opts(opts),
+    m_refresh_rate(0) {
 
 
     m_state.cycling = false;
@@ -287,6 +289,7 @@ BScreen::BScreen(FbTk::ResourceManager &rm,
 # endif
     XRRSelectInput(disp, rootWindow().window(), randr_mask);
 #endif // HAVE_RANDR
+    updateRefreshRate();
 
 
     _FB_USES_NLS;
@@ -332,6 +335,12 @@ BScreen::BScreen(FbTk::ResourceManager &rm,
     m_tracker.join(focusedWinFrameTheme()->reconfigSig(),
             FbTk::MemFun(*this, &BScreen::focusedWinFrameThemeReconfigured));
 
+    // windows out of sight render their decorations when shown, or
+    // before that once nothing else is going on
+    m_prerender_timer.setTimeout(100 * FbTk::FbTime::IN_MILLISECONDS);
+    m_prerender_timer.setFunctor(FbTk::MemFun(*this, &BScreen::prerenderFrames));
+    m_prerender_timer.fireOnce(true);
+
 
     renderGeomWindow();
     renderPosWindow();
@@ -620,6 +629,48 @@ void BScreen::focusedWinFrameThemeReconfigured() {
     for (; it != it_end; ++it)
         fluxbox->updateFrameExtents(*(*it)->fbwindow());
 
+    m_prerender_timer.start();
+}
+
+void BScreen::prerenderFrames() {
+    // don't get in the way of events
+    if (XPending(FbTk::App::instance()->display()) > 0) {
+        m_prerender_timer.start();
+        return;
+    }
+
+    // the workspace left last is the likeliest to be visited next, then
+    // the ones closest to the current
+    const unsigned int nr_ws = numberOfWorkspaces();
+    const unsigned int current = currentWorkspaceID();
+    vector<unsigned int> order;
+    if (m_former_workspace != current && m_former_workspace < nr_ws)
+        order.push_back(m_former_workspace);
+    for (unsigned int d = 1; d <= nr_ws / 2; ++d) {
+        unsigned int next = (current + d) % nr_ws;
+        unsigned int prev = (current + nr_ws - d) % nr_ws;
+        if (std::find(order.begin(), order.end(), next) == order.end())
+            order.push_back(next);
+        if (std::find(order.begin(), order.end(), prev) == order.end())
+            order.push_back(prev);
+    }
+
+    vector<FluxboxWindow *> wins;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Workspace::Windows &ws_wins = getWorkspace(order[i])->windowList();
+        wins.insert(wins.end(), ws_wins.begin(), ws_wins.end());
+    }
+    wins.insert(wins.end(), m_icon_list.begin(), m_icon_list.end());
+
+    // a few milliseconds per round, the next waits for the timer again
+    const uint64_t start = FbTk::FbTime::mono();
+    for (size_t i = 0; i < wins.size(); ++i) {
+        if (wins[i]->frame().prerender() &&
+            FbTk::FbTime::mono() - start > 5 * FbTk::FbTime::IN_MILLISECONDS) {
+            m_prerender_timer.start();
+            return;
+        }
+    }
 }
 
 void BScreen::propertyNotify(Atom atom) {
@@ -923,6 +974,7 @@ void BScreen::changeWorkspaceID(unsigned int id, bool revert) {
 
     // set new workspace
     Workspace *old = currentWorkspace();
+    m_former_workspace = old->workspaceID();
     m_current_workspace = getWorkspace(id);
 
     // we show new workspace first in order to appear faster
@@ -1113,6 +1165,9 @@ FluxboxWindow *BScreen::createWindow(Window client) {
         }
     }
 
+    // from here on properties are read when they change
+    winclient->releaseProperties();
+
     // add the window to the focus list
     // always add to front on startup to keep the focus order the same
     if (win->isFocused() || fluxbox->isStartup())
@@ -1510,6 +1565,7 @@ void BScreen::renderPosWindow() {
 void BScreen::updateSize() {
     // update xinerama layout
     initXinerama();
+    updateRefreshRate();
 
     // check if window geometry has changed
     if (rootWindow().updateGeometry()) {
@@ -1526,6 +1582,59 @@ void BScreen::updateSize() {
 }
 
 
+void BScreen::updateRefreshRate() {
+
+    m_refresh_rate = 0;
+
+#if defined(HAVE_RANDR)
+    Display *disp = FbTk::App::instance()->display();
+    XRRScreenResources *res = XRRGetScreenResourcesCurrent(disp, rootWindow().window());
+    if (res == 0)
+        return;
+
+    for (int c = 0; c < res->ncrtc; ++c) {
+        XRRCrtcInfo *crtc = XRRGetCrtcInfo(disp, res, res->crtcs[c]);
+        if (crtc == 0)
+            continue;
+
+        for (int m = 0; crtc->mode != None && m < res->nmode; ++m) {
+            const XRRModeInfo &mode = res->modes[m];
+            if (mode.id != crtc->mode)
+                continue;
+
+            double lines = mode.vTotal;
+            if (mode.modeFlags & RR_DoubleScan)
+                lines *= 2;
+            if (mode.modeFlags & RR_Interlace)
+                lines /= 2;
+
+            if (mode.hTotal != 0 && lines != 0) {
+                double rate = mode.dotClock / (mode.hTotal * lines);
+                m_refresh_rate = std::max(m_refresh_rate,
+                                          static_cast<unsigned int>(rate + 0.5));
+            }
+            break;
+        }
+        XRRFreeCrtcInfo(crtc);
+    }
+    XRRFreeScreenResources(res);
+#endif // HAVE_RANDR
+
+    fbdbg<<"BScreen::updateRefreshRate(): "<<m_refresh_rate<<" Hz"<<endl;
+}
+
+unsigned int BScreen::moveRate() const {
+
+    int rate = *resource.move_rate;
+    if (rate < 0)
+        return 0;
+    if (rate > 0)
+        return rate;
+
+    // follow the monitors, assume 60 Hz if RandR can't tell
+    return m_refresh_rate ? m_refresh_rate : 60;
+}
+
 /**
  * Find the winclient to this window's left
  * So, we check the leftgroup hint, and see if we know any windows
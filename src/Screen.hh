@@ -32,6 +32,7 @@
 #include "FbWinFrameTheme.hh"
 #include "TooltipWindow.hh"
 #include "ScreenResource.hh"
+#include "FrameIndex.hh"
 
 #include "FbTk/MenuTheme.hh"
 #include "FbTk/EventHandler.hh"
@@ -40,6 +41,7 @@
 #include "FbTk/NotCopyable.hh"
 #include "FbTk/Signal.hh"
 #include "FbTk/RelCalcHelper.hh"
+#include "FbTk/Timer.hh"
 
 #include "FocusControl.hh"
 
@@ -234,6 +236,11 @@ public:
 
     int getEdgeResizeSnapThreshold() const { return *resource.edge_resize_snap_threshold; }
 
+    /// @return how often per second opaque moving may move a window, 0 for no limit
+    unsigned int moveRate() const;
+    /// @return highest refresh rate (in Hz) of the monitors, 0 if unknown
+    unsigned int refreshRate() const { return m_refresh_rate; }
+
     void setRootColormapInstalled(bool r) { root_colormap_installed = r;  }
 
     void saveTabPlacement(FbWinFrame::TabPlacement place) { *resource.tab_placement = place; }
@@ -264,6 +271,9 @@ public:
 
     FbTk::MultLayers &layerManager() { return m_layermanager; }
     const FbTk::MultLayers &layerManager() const { return m_layermanager; }
+    /// where the windows of the workspaces are
+    FrameIndex &frameIndex() { return m_frame_index; }
+    const FrameIndex &frameIndex() const { return m_frame_index; }
     FbTk::ResourceManager &resourceManager() { return m_resource_manager; }
     const FbTk::ResourceManager &resourceManager() const { return m_resource_manager; }
     const std::string &name() const { return m_name; }
@@ -374,6 +384,8 @@ public:
 
     void initXinerama();
     void clearXinerama();
+    /// reads the refresh rates of the monitors from RandR
+    void updateRefreshRate();
     void clearHeads();
     /// clean up xinerama
 
@@ -451,6 +463,8 @@ private:
     void renderGeomWindow();
     void renderPosWindow();
     void focusedWinFrameThemeReconfigured();
+    /// renders the decorations of hidden windows, a few at a time
+    void prerenderFrames();
 
     int getGap(int head, const char type);
     float getXGap(int head);
@@ -472,6 +486,7 @@ private:
     ScreenSignal m_workspacenames_sig; ///< workspace names signal
 
     FbTk::MultLayers m_layermanager;
+    FrameIndex m_frame_index;
 
     bool root_colormap_installed;
 
@@ -484,6 +499,8 @@ private:
     std::auto_ptr<Toolbar>  m_toolbar;
 
     Workspace *m_current_workspace;
+    unsigned int m_former_workspace; ///< the workspace left last
+    FbTk::Timer m_prerender_timer;
 
     WorkspaceNames m_workspace_names;
     Workspaces m_workspaces_list;
@@ -543,6 +560,7 @@ private:
         bool managed;
     } m_state;
     unsigned int m_opts; // hold Fluxbox::OPT_SLIT etc
+    unsigned int m_refresh_rate; ///< highest refresh rate of the monitors, 0 if unknown
 };
 
 
@@ -104,6 +104,7 @@ ScreenResource::ScreenResource(FbTk::ResourceManager& rm,
     menu_delay(rm, 200, scrname + ".menuDelay", altscrname+".MenuDelay"),
     tab_width(rm, 64, scrname + ".tab.width", altscrname+".Tab.Width"),
     tooltip_delay(rm, 500, scrname + ".tooltipDelay", altscrname+".TooltipDelay"),
+    move_rate(rm, 0, scrname + ".moveRate", altscrname+".MoveRate"),
     allow_remote_actions(rm, false, scrname+".allowRemoteActions", altscrname+".AllowRemoteActions"),
     clientmenu_use_pixmap(rm, true, scrname+".clientMenu.usePixmap", altscrname+".ClientMenu.UsePixmap"),
     tabs_use_pixmap(rm, true, scrname+".tabs.usePixmap", altscrname+".Tabs.UsePixmap"),
@@ -53,7 +53,8 @@ struct ScreenResource {
         menu_alpha,
         menu_delay,
         tab_width,
-        tooltip_delay;
+        tooltip_delay,
+        move_rate;
     FbTk::Resource<bool> allow_remote_actions;
     FbTk::Resource<bool> clientmenu_use_pixmap;
     FbTk::Resource<bool> tabs_use_pixmap;
@@ -31,11 +31,14 @@
 
 #include "FbTk/EventManager.hh"
 #include "FbTk/MultLayers.hh"
+#include "FbTk/PropertySnapshot.hh"
+#include "FbTk/StringUtil.hh"
 
 #include <iostream>
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <vector>
 #include <X11/Xatom.h>
 
 #ifdef HAVE_CASSERT
@@ -74,6 +77,124 @@ void sendMessage(const WinClient& win, Atom atom, Time time) {
     XSendEvent(win.display(), win.window(), false, NoEventMask, &ce);
 }
 
+// read while a client is adopted, by WinClient itself, the atom handlers
+// and the apps file matching
+const char *s_adoption_atom_names[] = {
+    "WM_PROTOCOLS",
+    "WM_STATE",
+    "WM_WINDOW_ROLE",
+    "_MOTIF_WM_HINTS",
+    "_FLUXBOX_GROUP_LEFT",
+    "_NET_WM_NAME",
+    "_NET_WM_ICON",
+    "_NET_WM_WINDOW_TYPE",
+    "_NET_WM_STRUT",
+    "_NET_WM_DESKTOP",
+    "_NET_WM_STATE"
+};
+
+const std::vector<Atom> &adoptionAtoms(Display *disp) {
+    static std::vector<Atom> atoms;
+    if (atoms.empty()) {
+        const int count = sizeof(s_adoption_atom_names) / sizeof(s_adoption_atom_names[0]);
+        atoms.resize(count);
+        XInternAtoms(disp, const_cast<char **>(s_adoption_atom_names), count,
+                     False, &atoms[0]);
+        atoms.push_back(XA_WM_NAME);
+        atoms.push_back(XA_WM_CLASS);
+        atoms.push_back(XA_WM_HINTS);
+        atoms.push_back(XA_WM_NORMAL_HINTS);
+        atoms.push_back(XA_WM_TRANSIENT_FOR);
+    }
+    return atoms;
+}
+
+// WM_HINTS and WM_NORMAL_HINTS are read the way XGetWMHints and
+// XGetWMNormalHints do, so they can come from the snapshot as well
+enum {
+    NR_WM_HINTS = 9,
+    NR_OLD_SIZE_HINTS = 15,
+    NR_SIZE_HINTS = 18
+};
+
+bool readWMHints(const WinClient &client, XWMHints &hints) {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    long *data = 0;
+
+    if (!client.property(XA_WM_HINTS, 0, NR_WM_HINTS, False, XA_WM_HINTS,
+                         &type, &format, &nitems, &bytes_after,
+                         reinterpret_cast<unsigned char **>(&data)) || data == 0)
+        return false;
+
+    // the window group was added later on
+    bool ok = type == XA_WM_HINTS && format == 32 && nitems >= NR_WM_HINTS - 1;
+    if (ok) {
+        hints.flags = data[0];
+        hints.input = data[1] != 0;
+        hints.initial_state = data[2];
+        hints.icon_pixmap = data[3];
+        hints.icon_window = data[4];
+        hints.icon_x = data[5];
+        hints.icon_y = data[6];
+        hints.icon_mask = data[7];
+        if (nitems >= NR_WM_HINTS)
+            hints.window_group = data[8];
+        else {
+            hints.window_group = 0;
+            hints.flags &= ~WindowGroupHint;
+        }
+    }
+
+    XFree(data);
+    return ok;
+}
+
+bool readWMNormalHints(const WinClient &client, XSizeHints &hints) {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    long *data = 0;
+
+    if (!client.property(XA_WM_NORMAL_HINTS, 0, NR_SIZE_HINTS, False, XA_WM_SIZE_HINTS,
+                         &type, &format, &nitems, &bytes_after,
+                         reinterpret_cast<unsigned char **>(&data)) || data == 0)
+        return false;
+
+    bool ok = type == XA_WM_SIZE_HINTS && format == 32 && nitems >= NR_OLD_SIZE_HINTS;
+    if (ok) {
+        long supplied = USPosition | USSize | PAllHints;
+        hints.flags = data[0];
+        hints.x = data[1];
+        hints.y = data[2];
+        hints.width = data[3];
+        hints.height = data[4];
+        hints.min_width = data[5];
+        hints.min_height = data[6];
+        hints.max_width = data[7];
+        hints.max_height = data[8];
+        hints.width_inc = data[9];
+        hints.height_inc = data[10];
+        hints.min_aspect.x = data[11];
+        hints.min_aspect.y = data[12];
+        hints.max_aspect.x = data[13];
+        hints.max_aspect.y = data[14];
+        hints.base_width = hints.base_height = 0;
+        hints.win_gravity = 0;
+        if (nitems >= NR_SIZE_HINTS) {
+            supplied |= PBaseSize | PWinGravity;
+            hints.base_width = data[15];
+            hints.base_height = data[16];
+            hints.win_gravity = data[17];
+        }
+        hints.flags &= supplied;
+    }
+
+    XFree(data);
+    return ok;
+}
+
 } // end of anonymous namespace
 
 WinClient::TransientWaitMap WinClient::s_transient_wait;
@@ -95,7 +216,11 @@ WinClient::WinClient(Window win, BScreen &screen, FluxboxWindow *fbwin):
                      m_icon_override(false),
                      m_window_type(WindowState::TYPE_NORMAL),
                      m_mwm_hint(0),
-                     m_strut(0) {
+                     m_strut(0),
+                     m_snapshot(new FbTk::PropertySnapshot(display(), win)) {
+
+    const std::vector<Atom> &atoms = adoptionAtoms(display());
+    m_snapshot->fetch(&atoms[0], atoms.size());
 
     old_bw = borderWidth();
     updateWMProtocols();
@@ -171,6 +296,7 @@ WinClient::~WinClient() {
     if (m_mwm_hint != 0)
         XFree(m_mwm_hint);
 
+    delete m_snapshot;
 }
 
 bool WinClient::acceptsFocus() const {
@@ -212,11 +338,11 @@ bool WinClient::getAttrib(XWindowAttributes &attr) const {
 }
 
 bool WinClient::getWMName(XTextProperty &textprop) const {
-    return XGetWMName(display(), window(), &textprop);
+    return rawTextProperty(XA_WM_NAME, textprop);
 }
 
 bool WinClient::getWMIconName(XTextProperty &textprop) const {
-    return XGetWMIconName(display(), window(), &textprop);
+    return rawTextProperty(XA_WM_ICON_NAME, textprop);
 }
 
 string WinClient::getWMRole() const {
@@ -225,10 +351,77 @@ string WinClient::getWMRole() const {
     return textProperty(wm_role);
 }
 
-void WinClient::updateWMClassHint() {
+const FbTk::FbString &WinClient::cachedWMRole() const {
+    static Atom wm_role = XInternAtom(FbTk::App::instance()->display(),
+                                      "WM_WINDOW_ROLE", False);
+    return cachedTextProperty(wm_role);
+}
+
+const FbTk::FbString &WinClient::cachedTextProperty(Atom prop) const {
+    PropertyCache::iterator it = m_text_properties.find(prop);
+    if (it == m_text_properties.end())
+        it = m_text_properties.insert(std::make_pair(prop, textProperty(prop))).first;
+    return it->second;
+}
+
+const FbTk::FbString &WinClient::cachedCardinalProperty(Atom prop) const {
+    PropertyCache::iterator it = m_cardinal_properties.find(prop);
+    if (it == m_cardinal_properties.end()) {
+        FbTk::FbString value = FbTk::StringUtil::number2String(cardinalProperty(prop));
+        it = m_cardinal_properties.insert(std::make_pair(prop, value)).first;
+    }
+    return it->second;
+}
+
+void WinClient::propertyChanged(Atom prop) {
+    m_text_properties.erase(prop);
+    m_cardinal_properties.erase(prop);
+}
+
+void WinClient::releaseProperties() {
+    delete m_snapshot;
+    m_snapshot = 0;
+}
+
+bool WinClient::property(Atom prop,
+                         long long_offset, long long_length,
+                         bool do_delete,
+                         Atom req_type,
+                         Atom *actual_type_return,
+                         int *actual_format_return,
+                         unsigned long *nitems_return,
+                         unsigned long *bytes_after_return,
+                         unsigned char **prop_return) const {
+    if (m_snapshot != 0 && long_offset == 0 && !do_delete &&
+        m_snapshot->get(prop, long_length, req_type,
+                        actual_type_return, actual_format_return,
+                        nitems_return, bytes_after_return, prop_return))
+        return true;
 
-    m_instance_name = Xutil::getWMClassName(window());
-    m_class_name = Xutil::getWMClassClass(window());
+    return FbTk::FbWindow::property(prop, long_offset, long_length, do_delete,
+                                    req_type, actual_type_return,
+                                    actual_format_return, nitems_return,
+                                    bytes_after_return, prop_return);
+}
+
+void WinClient::changeProperty(Atom prop, Atom type,
+                               int format,
+                               int mode,
+                               unsigned char *data,
+                               int nelements) {
+    if (m_snapshot != 0)
+        m_snapshot->forget(prop);
+    FbTk::FbWindow::changeProperty(prop, type, format, mode, data, nelements);
+}
+
+void WinClient::deleteProperty(Atom prop) {
+    if (m_snapshot != 0)
+        m_snapshot->forget(prop);
+    FbTk::FbWindow::deleteProperty(prop);
+}
+
+void WinClient::updateWMClassHint() {
+    Xutil::getWMClass(*this, m_instance_name, m_class_name);
 }
 
 void WinClient::updateTransientInfo() {
@@ -242,7 +435,18 @@ void WinClient::updateTransientInfo() {
     transient_for = 0;
     // determine if this is a transient window
     Window win = 0;
-    if (!XGetTransientForHint(display(), window(), &win)) {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    Window *data = 0;
+    if (property(XA_WM_TRANSIENT_FOR, 0, 1, False, XA_WINDOW,
+                 &type, &format, &nitems, &bytes_after,
+                 reinterpret_cast<unsigned char **>(&data)) && data != 0) {
+        if (type == XA_WINDOW && format == 32 && nitems != 0)
+            win = data[0];
+        XFree(data);
+    }
+    if (win == 0) {
 
         fbdbg<<__FUNCTION__<<": window() = 0x"<<hex<<window()<<dec<<"Failed to read transient for hint."<<endl;
         return;
@@ -313,7 +517,7 @@ void WinClient::updateTitle() {
     if (m_title_override)
         return;
 
-    m_title.setLogical(FbTk::FbString(Xutil::getWMName(window()), 0, 512));
+    m_title.setLogical(FbTk::FbString(Xutil::getWMName(*this), 0, 512));
     titleSig().emit(m_title.logical(), *this);
 }
 
@@ -361,7 +565,8 @@ void WinClient::updateMWMHints() {
 }
 
 void WinClient::updateWMHints() {
-    XWMHints *wmhint = XGetWMHints(display(), window());
+    XWMHints hints;
+    XWMHints *wmhint = readWMHints(*this, hints) ? &hints : 0;
     accepts_input = true;
     window_group = None;
     initial_state = NormalState;
@@ -409,16 +614,13 @@ void WinClient::updateWMHints() {
                 Fluxbox::instance()->attentionHandler().windowFocusChanged(*this);
             }
         }
-
-        XFree(wmhint);
     }
 }
 
 
 void WinClient::updateWMNormalHints() {
-    long icccm_mask;
     XSizeHints sizehint;
-    if (!XGetWMNormalHints(display(), window(), &sizehint, &icccm_mask))
+    if (!readWMNormalHints(*this, sizehint))
         sizehint.flags = 0;
 
     normal_hint_flags = sizehint.flags;
@@ -548,16 +750,21 @@ void WinClient::setAttentionState(bool value) {
 }
 
 void WinClient::updateWMProtocols() {
+    Atom type;
+    int format;
+    unsigned long num_return = 0, bytes_after;
     Atom *proto = 0;
-    int num_return = 0;
     FbAtoms *fbatoms = FbAtoms::instance();
 
-    if (XGetWMProtocols(display(), window(), &proto, &num_return)) {
+    if (property(fbatoms->getWMProtocolsAtom(), 0, 1000000, False, XA_ATOM,
+                 &type, &format, &num_return, &bytes_after,
+                 reinterpret_cast<unsigned char **>(&proto)) && proto != 0 &&
+        type == XA_ATOM && format == 32) {
 
         // defaults
         send_focus_message = false;
         send_close_message = false;
-        for (int i = 0; i < num_return; ++i) {
+        for (unsigned long i = 0; i < num_return; ++i) {
             if (proto[i] == fbatoms->getWMDeleteAtom())
                 send_close_message = true;
             else if (proto[i] == fbatoms->getWMTakeFocusAtom())
@@ -569,6 +776,8 @@ void WinClient::updateWMProtocols() {
             fbwindow()->updateFunctions();
 
     } else {
+        if (proto != 0)
+            XFree(proto);
         fbdbg<<"Warning: Failed to read WM Protocols. "<<endl;
     }
 
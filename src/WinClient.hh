@@ -31,6 +31,10 @@
 class BScreen;
 class Strut;
 
+namespace FbTk {
+class PropertySnapshot;
+}
+
 /// Holds client window info 
 class WinClient: public Focusable, public FbTk::FbWindow {
 public:
@@ -99,6 +103,41 @@ public:
     long getCardinalProperty(Atom prop,bool*exists=NULL) const { return FbTk::FbWindow::cardinalProperty(prop,exists); }
     FbTk::FbString getTextProperty(Atom prop,bool*exists=NULL) const { return FbTk::FbWindow::textProperty(prop,exists); }
 
+    /**
+       Copies of X properties for pattern matching. They are fetched once
+       and kept until a PropertyNotify for them arrives.
+       @see propertyChanged
+    */
+    const FbTk::FbString &cachedTextProperty(Atom prop) const;
+    /// @return cardinal property prop as decimal string
+    const FbTk::FbString &cachedCardinalProperty(Atom prop) const;
+    const FbTk::FbString &cachedWMRole() const;
+    /// drops the cached copies of prop
+    void propertyChanged(Atom prop);
+
+    /**
+       The properties read while adopting the client are fetched together
+       when it's created and served from there, until this is called at
+       the end of the adoption.
+    */
+    void releaseProperties();
+
+    bool property(Atom property,
+                  long long_offset, long long_length,
+                  bool do_delete,
+                  Atom req_type,
+                  Atom *actual_type_return,
+                  int *actual_format_return,
+                  unsigned long *nitems_return,
+                  unsigned long *bytes_after_return,
+                  unsigned char **prop_return) const;
+    void changeProperty(Atom property, Atom type,
+                        int format,
+                        int mode,
+                        unsigned char *data,
+                        int nelements);
+    void deleteProperty(Atom property);
+
     WinClient *transientFor() { return transient_for; }
     const WinClient *transientFor() const { return transient_for; }
     TransientList &transientList() { return transients; }
@@ -162,6 +201,13 @@ private:
     SizeHints m_size_hints;
 
     Strut *m_strut;
+
+    FbTk::PropertySnapshot *m_snapshot;
+
+    typedef std::map<Atom, FbTk::FbString> PropertyCache;
+    mutable PropertyCache m_text_properties;
+    mutable PropertyCache m_cardinal_properties;
+
     // map transient_for X window to winclient transient 
     // (used if transient_for FbWindow was created after transient)    
     // Since a lot of transients can be created before transient_for 
@@ -76,6 +76,7 @@ using std::bind2nd;
 using std::mem_fun;
 using std::equal_to;
 using std::max;
+using std::min;
 using std::swap;
 using std::dec;
 using std::hex;
@@ -221,20 +222,17 @@ private:
 /// helper class for some STL routines
 class ChangeProperty {
 public:
-    ChangeProperty(Display *disp, Atom prop, int mode,
-                   unsigned char *state, int num):m_disp(disp),
-                                                  m_prop(prop),
+    ChangeProperty(Atom prop, int mode,
+                   unsigned char *state, int num):m_prop(prop),
                                                   m_state(state),
                                                   m_num(num),
                                                   m_mode(mode){
 
     }
     void operator () (FbTk::FbWindow *win) {
-        XChangeProperty(m_disp, win->window(), m_prop, m_prop, 32, m_mode,
-                        m_state, m_num);
+        win->changeProperty(m_prop, m_prop, 32, m_mode, m_state, m_num);
     }
 private:
-    Display *m_disp;
     Atom m_prop;
     unsigned char *m_state;
     int m_num;
@@ -277,12 +275,14 @@ FluxboxWindow::FluxboxWindow(WinClient &client):
     Focusable(client.screen(), this),
     oplock(false),
     m_creation_time(0),
+    m_last_move_time(0),
     moving(false), resizing(false),
     m_initialized(false),
     m_attaching_tab(0),
     display(FbTk::App::instance()->display()),
     m_button_grab_x(0), m_button_grab_y(0),
     m_last_move_x(0), m_last_move_y(0),
+    m_pending_move_x(0), m_pending_move_y(0),
     m_last_resize_h(1), m_last_resize_w(1),
     m_last_pressed_button(0),
     m_workspace_number(0),
@@ -306,6 +306,7 @@ FluxboxWindow::FluxboxWindow(WinClient &client):
 
     join(m_theme.reconfigSig(), FbTk::MemFun(*this, &FluxboxWindow::themeReconfigured));
     join(m_frame.frameExtentSig(), FbTk::MemFun(*this, &FluxboxWindow::frameExtentChanged));
+    join(m_frame.geometrySig(), FbTk::MemFun(*this, &FluxboxWindow::frameGeometryChanged));
 
     init();
 
@@ -361,6 +362,9 @@ FluxboxWindow::~FluxboxWindow() {
 
     m_timer.stop();
 
+    // in case a workspace still lists us
+    screen().frameIndex().remove(*this);
+
     // notify die
     dieSig().emit(*this);
 
@@ -441,6 +445,9 @@ void FluxboxWindow::init() {
     m_timer.setCommand(raise_cmd);
     m_timer.fireOnce(true);
 
+    m_move_timer.setFunctor(FbTk::MemFun(*this, &FluxboxWindow::applyMove));
+    m_move_timer.fireOnce(true);
+
     /**************************************************/
     /* Read state above here, apply state below here. */
     /**************************************************/
@@ -1845,10 +1852,9 @@ void FluxboxWindow::setState(unsigned long new_state, bool setting_up) {
     state[1] = (unsigned long) None;
 
     for_each(m_clientlist.begin(), m_clientlist.end(),
-             ChangeProperty(display,
-                                  FbAtoms::instance()->getWMStateAtom(),
-                                  PropModeReplace,
-                                  (unsigned char *)state, 2));
+             ChangeProperty(FbAtoms::instance()->getWMStateAtom(),
+                            PropModeReplace,
+                            (unsigned char *)state, 2));
 
     ClientList::iterator it = clientList().begin();
     ClientList::iterator it_end = clientList().end();
@@ -2075,6 +2081,8 @@ void FluxboxWindow::destroyNotifyEvent(XDestroyWindowEvent &de) {
 
 
 void FluxboxWindow::propertyNotifyEvent(WinClient &client, Atom atom) {
+    client.propertyChanged(atom);
+
     switch(atom) {
     case XA_WM_CLASS:
     case XA_WM_CLIENT_MACHINE:
@@ -2473,13 +2481,11 @@ void FluxboxWindow::motionNotifyEvent(XMotionEvent &me) {
             }
             m_last_move_x = dx;
             m_last_move_y = dy;
+            screen().showPosition(dx, dy);
         } else {
-            //moveResize(dx, dy, frame().width(), frame().height());
-            // need to move the base window without interfering with transparency
-            frame().quietMoveResize(dx, dy, frame().width(), frame().height());
+            scheduleMove(dx, dy);
         }
 
-        screen().showPosition(dx, dy);
         // end if moving
     } else if (resizing) {
 
@@ -2729,6 +2735,30 @@ void FluxboxWindow::frameExtentChanged() {
     }
 }
 
+void FluxboxWindow::frameBounds(int &left, int &top, int &right, int &bottom) const {
+
+    int bw = frame().window().borderWidth();
+    left = x();
+    top = y();
+    right = x() + width() + 2 * bw;
+    bottom = y() + height() + 2 * bw;
+
+    if (frame().externalTabMode()) {
+        left = min(left, x() - xOffset());
+        top = min(top, y() - yOffset());
+        right = max(right, x() - xOffset() + static_cast<int>(width()) +
+                    2 * bw + widthOffset());
+        bottom = max(bottom, y() - yOffset() + static_cast<int>(height()) +
+                     2 * bw + heightOffset());
+    }
+}
+
+void FluxboxWindow::frameGeometryChanged() {
+    int left, top, right, bottom;
+    frameBounds(left, top, right, bottom);
+    screen().frameIndex().update(*this, left, top, right, bottom);
+}
+
 void FluxboxWindow::themeReconfigured() {
     frame().applyDecorations();
     sendConfigureNotify();
@@ -2852,7 +2882,46 @@ void FluxboxWindow::startMoving(int x, int y) {
     }
 }
 
+void FluxboxWindow::scheduleMove(int x, int y) {
+
+    m_pending_move_x = x;
+    m_pending_move_y = y;
+
+    unsigned int rate = screen().moveRate();
+    uint64_t interval = rate ? FbTk::FbTime::IN_SECONDS / rate : 0;
+    uint64_t now = FbTk::FbTime::mono();
+
+    if (now - m_last_move_time >= interval) {
+        m_move_timer.stop();
+        applyMove();
+    } else if (!m_move_timer.isTiming()) {
+        // the timer applies whatever position is pending by then
+        m_move_timer.setTimeout(m_last_move_time + interval - now);
+        m_move_timer.start();
+    }
+}
+
+void FluxboxWindow::applyMove() {
+
+    if (!moving)
+        return;
+
+    m_last_move_time = FbTk::FbTime::mono();
+
+    // need to move the base window without interfering with transparency
+    frame().quietMoveResize(m_pending_move_x, m_pending_move_y,
+                            frame().width(), frame().height());
+    screen().showPosition(m_pending_move_x, m_pending_move_y);
+}
+
 void FluxboxWindow::stopMoving(bool interrupted) {
+
+    if (m_move_timer.isTiming()) {
+        m_move_timer.stop();
+        if (!interrupted)
+            applyMove();
+    }
+
     moving = false;
     Fluxbox *fluxbox = Fluxbox::instance();
 
@@ -3015,11 +3084,18 @@ void FluxboxWindow::doSnapping(int &orig_left, int &orig_top, bool resize) {
     /////////////////////////////////////
     // now check window edges
 
-    Workspace::Windows &wins =
-        screen().currentWorkspace()->windowList();
-
-    Workspace::Windows::iterator it = wins.begin();
-    Workspace::Windows::iterator it_end = wins.end();
+    // only windows within the threshold of our frame (or tabs) can
+    // change anything, ask the index for those
+    FrameIndex::Windows wins;
+    screen().frameIndex().find(*screen().currentWorkspace(),
+                               min(left, left - xoff) - threshold - 1,
+                               min(top, top - yoff) - threshold - 1,
+                               max(right, right - xoff + woff) + threshold + 1,
+                               max(bottom, bottom - yoff + hoff) + threshold + 1,
+                               wins);
+
+    FrameIndex::Windows::iterator it = wins.begin();
+    FrameIndex::Windows::iterator it_end = wins.end();
 
     unsigned int bw;
     for (; it != it_end; ++it) {
@@ -439,6 +439,8 @@ public:
     int yOffset() const { return frame().yOffset(); }
     int widthOffset() const { return frame().widthOffset(); }
     int heightOffset() const { return frame().heightOffset(); }
+    /// the smallest rectangle holding the frame and the external tabs
+    void frameBounds(int &left, int &top, int &right, int &bottom) const;
 
     unsigned int workspaceNumber() const { return m_workspace_number; }
 
@@ -503,6 +505,10 @@ private:
 
     // modifies left and top if snap is necessary
     void doSnapping(int &left, int &top, bool resize = false);
+    /// moves the frame to the pending position, at most screen().moveRate() times a second
+    void scheduleMove(int x, int y);
+    /// moves the frame to the pending position now
+    void applyMove();
     // user_w/h return the values that should be shown to the user
     void fixSize();
     void moveResizeClient(WinClient &client);
@@ -524,6 +530,8 @@ private:
     /// Called when workspace area on screen changed.
     void workspaceAreaChanged(BScreen &screen);
     void frameExtentChanged();
+    /// keeps the screen's FrameIndex up to date
+    void frameGeometryChanged();
 
 
     // state and hint signals
@@ -532,6 +540,8 @@ private:
     uint64_t m_creation_time;
     uint64_t m_last_keypress_time;
     FbTk::Timer m_timer;
+    FbTk::Timer m_move_timer; ///< applies the pending opaque move
+    uint64_t m_last_move_time; ///< when the frame was moved last during opaque moving
 
     // Window states
     bool moving, resizing, m_initialized;
@@ -543,6 +553,7 @@ private:
     int m_button_grab_x, m_button_grab_y; // handles last button press event for move
     int m_last_resize_x, m_last_resize_y; // handles last button press event for resize
     int m_last_move_x, m_last_move_y; // handles last pos for non opaque moving
+    int m_pending_move_x, m_pending_move_y; // where opaque moving goes next
     int m_last_resize_h, m_last_resize_w; // handles height/width for resize "window"
     int m_last_pressed_button;
 
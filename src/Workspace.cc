@@ -81,6 +81,9 @@ void Workspace::addWindow(FluxboxWindow &w) {
     w.setWorkspace(m_id);
 
     m_windowlist.push_back(&w);
+    int left, top, right, bottom;
+    w.frameBounds(left, top, right, bottom);
+    m_screen.frameIndex().add(w, *this, left, top, right, bottom);
     m_clientlist_sig.emit();
 
 }
@@ -103,6 +106,7 @@ int Workspace::removeWindow(FluxboxWindow *w, bool still_alive) {
         FocusControl::unfocusWindow(w->winClient(), true, true);
 
     m_windowlist.remove(w);
+    m_screen.frameIndex().remove(*w);
     m_clientlist_sig.emit();
 
     return m_windowlist.size();
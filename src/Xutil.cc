@@ -25,10 +25,12 @@
 
 #include "FbTk/I18n.hh"
 #include "FbTk/App.hh"
+#include "FbTk/FbWindow.hh"
 
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
 #include <iostream>
+#include <cstdio>
 
 #ifdef HAVE_CSTRING
   #include <cstring>
@@ -43,12 +45,12 @@ using std::endl;
 
 namespace Xutil {
 
-FbTk::FbString getWMName(Window window) {
+FbTk::FbString getWMName(const FbTk::FbWindow &win) {
 
-    if (window == None)
+    if (win.window() == None)
         return FbTk::FbString("");
 
-    Display *display = FbTk::App::instance()->display();
+    Display *display = win.display();
 
     XTextProperty text_prop;
     text_prop.value = 0;
@@ -57,7 +59,7 @@ FbTk::FbString getWMName(Window window) {
     _FB_USES_NLS;
     FbTk::FbString name;
 
-    if (XGetWMName(display, window, &text_prop)) {
+    if (win.rawTextProperty(XA_WM_NAME, text_prop)) {
         if (text_prop.value && text_prop.nitems > 0) {
             if (text_prop.encoding != XA_STRING) {
 
@@ -89,6 +91,33 @@ FbTk::FbString getWMName(Window window) {
 }
 
 
+void getWMClass(const FbTk::FbWindow &win,
+                FbTk::FbString &instance_name, FbTk::FbString &class_name) {
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    char *data = 0;
+
+    instance_name = class_name = "";
+
+    // read the way XGetClassHint does: "name\0class\0"
+    if (!win.property(XA_WM_CLASS, 0, BUFSIZ, False, XA_STRING,
+                      &type, &format, &nitems, &bytes_after,
+                      reinterpret_cast<unsigned char **>(&data)) || data == 0) {
+        fbdbg<<"Xutil: Failed to read class hint!"<<endl;
+        return;
+    }
+
+    if (type == XA_STRING && format == 8) {
+        instance_name = data;
+        size_t name_len = strlen(data);
+        if (name_len + 1 < nitems)
+            class_name = data + name_len + 1;
+    }
+
+    XFree(data);
+}
+
 // The name of this particular instance
 FbTk::FbString getWMClassName(Window win) {
 
@@ -26,9 +26,17 @@
 #include <X11/Xlib.h>
 #include "FbTk/FbString.hh"
 
+namespace FbTk {
+class FbWindow;
+}
+
 namespace Xutil {
 
-FbTk::FbString getWMName(Window window);
+FbTk::FbString getWMName(const FbTk::FbWindow &win);
+
+/// reads WM_CLASS once for both of its names
+void getWMClass(const FbTk::FbWindow &win,
+                FbTk::FbString &instance_name, FbTk::FbString &class_name);
 
 FbTk::FbString getWMClassName(Window win);
 FbTk::FbString getWMClassClass(Window win);
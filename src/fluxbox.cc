@@ -52,10 +52,13 @@
 #include "FbTk/RefCount.hh"
 #include "FbTk/CompareEqual.hh"
 #include "FbTk/Transparent.hh"
+#include "FbTk/TextureRender.hh"
 #include "FbTk/Select2nd.hh"
 #include "FbTk/Compose.hh"
 #include "FbTk/KeyUtil.hh"
 #include "FbTk/MemFun.hh"
+#include "FbTk/Reactor.hh"
+#include "FbTk/LatencyStats.hh"
 
 #ifdef USE_EWMH
 #include "Ewmh.hh"
@@ -159,6 +162,12 @@ int handleXErrors(Display *d, XErrorEvent *e) {
     return False;
 }
 
+/// the event loop reads the x events itself, the reactor only wakes it up
+class XConnectionHandler: public FbTk::Reactor::Handler {
+public:
+    void handleFd(int) { }
+};
+
 
 int handleXIOErrors(Display* d) {
     cerr << "Fluxbox: XIOError: lost connection to display.\n";
@@ -255,6 +264,8 @@ Fluxbox::Config::Config(FbTk::ResourceManager& rm, const std::string& path) :
     menusearch(rm, FbTk::MenuSearch::DEFAULT, "session.menuSearch", "Session.MenuSearch"),
     cache_life(rm, 5, "session.cacheLife", "Session.CacheLife"),
     cache_max(rm, 200, "session.cacheMax", "Session.CacheMax"),
+    render_threads(rm, 1, "session.renderThreads", "Session.RenderThreads"),
+    timer_slack(rm, 2, "session.timerSlack", "Session.TimerSlack"),
     auto_raise_delay(rm, 250, "session.autoRaiseDelay", "Session.AutoRaiseDelay") {
 }
 
@@ -482,6 +493,8 @@ Fluxbox::~Fluxbox() {
     FbTk::STLUtil::destroyAndClear(m_screens);
 
     FbTk::STLUtil::destroyAndClear(m_atomhandler);
+
+    FbTk::Reactor::shutdown();
 }
 
 
@@ -522,10 +535,20 @@ void Fluxbox::initScreen(BScreen *screen) {
 void Fluxbox::eventLoop() {
 
     Display *disp = display();
+    XConnectionHandler x_connection;
+
+    FbTk::Reactor::add(ConnectionNumber(disp), x_connection);
 
     while (!m_state.shutdown) {
 
-        if (XPending(disp)) {
+        // handle the events which are queued already as one batch; the
+        // handlers might queue more, those are left for the next round so
+        // timers and other file descriptors get their turn in between.
+        // Handlers also take events out of the queue (XCheckTypedEvent),
+        // so look again before each one, XNextEvent would block otherwise
+        int batch = XEventsQueued(disp, QueuedAfterReading);
+        for (; batch > 0 && !m_state.shutdown &&
+                 XEventsQueued(disp, QueuedAlready) > 0; --batch) {
             XEvent e;
             XNextEvent(disp, &e);
 
@@ -537,12 +560,22 @@ void Fluxbox::eventLoop() {
                     fbdbg<<"Fluxbox::eventLoop(): removing bad window from event queue"<<endl;
             } else {
                 last_bad_window = None;
-                handleEvent(&e);
+                if (FbTk::LatencyStats::enabled()) {
+                    uint64_t start = FbTk::FbTime::mono();
+                    handleEvent(&e);
+                    FbTk::LatencyStats::add("event " + FbTk::LatencyStats::eventName(e.type), start);
+                } else {
+                    handleEvent(&e);
+                }
             }
-        } else {
-            FbTk::Timer::updateTimers(ConnectionNumber(disp));
         }
+
+        // XPending() flushes our requests, only sleep if the server has
+        // nothing more for us
+        FbTk::Reactor::dispatch(!m_state.shutdown && XPending(disp) == 0);
     }
+
+    FbTk::Reactor::remove(ConnectionNumber(disp));
 }
 
 bool Fluxbox::validateWindow(Window window) const {
@@ -1180,6 +1213,8 @@ void Fluxbox::load_rc() {
         m_config.menu_file.setDefaultValue();
 
     FbTk::Transparent::usePseudoTransparent(*m_config.pseudotrans);
+    FbTk::TextureRender::setRenderThreads(*m_config.render_threads);
+    FbTk::Timer::setSlack(*m_config.timer_slack * FbTk::FbTime::IN_MILLISECONDS);
 
     if (m_config.slit_file->empty()) {
         string filename = getDefaultDataFilename("slitlist");
@@ -1257,6 +1292,8 @@ void Fluxbox::reconfigure() {
 void Fluxbox::real_reconfigure() {
 
     FbTk::Transparent::usePseudoTransparent(*m_config.pseudotrans);
+    FbTk::TextureRender::setRenderThreads(*m_config.render_threads);
+    FbTk::Timer::setSlack(*m_config.timer_slack * FbTk::FbTime::IN_MILLISECONDS);
 
     ScreenList::iterator screen_it = m_screens.begin();
     ScreenList::iterator screen_it_end = m_screens.end();
@@ -49,6 +49,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <cstdio>
@@ -255,6 +256,8 @@ private:
         FbTk::Resource<FbTk::MenuSearch::Mode> menusearch;
         FbTk::Resource<unsigned int>   cache_life;
         FbTk::Resource<unsigned int>   cache_max;
+        FbTk::Resource<unsigned int>   render_threads;
+        FbTk::Resource<unsigned int>   timer_slack;
         FbTk::Resource<time_t>         auto_raise_delay;
     } m_config;
 
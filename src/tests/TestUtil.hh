@@ -0,0 +1,58 @@
+// TestUtil.hh
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// the checks shared by the self checking tests: a failed check is printed
+// and remembered, the test runs on and main() ends with
+//
+//     return TestUtil::report("name");
+
+#ifndef TESTUTIL_HH
+#define TESTUTIL_HH
+
+#include <cstdlib>
+#include <iostream>
+
+namespace TestUtil {
+
+/// false once a check failed
+inline bool &passed() {
+    static bool s_passed = true;
+    return s_passed;
+}
+
+/// prints what failed if cond doesn't hold, returns cond
+inline bool check(bool cond, const char *what) {
+    if (!cond) {
+        std::cerr << "failed: " << what << std::endl;
+        passed() = false;
+    }
+    return cond;
+}
+
+/// prints the verdict of the test and returns the exit status for main()
+inline int report(const char *name) {
+    std::cerr << name << (passed() ? " ok" : " FAILED") << std::endl;
+    return passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // end namespace TestUtil
+
+#endif // TESTUTIL_HH
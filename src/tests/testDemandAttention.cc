@@ -28,6 +28,7 @@
 #include "FbTk/Color.hh"
 #include "FbTk/SimpleCommand.hh"
 #include "FbTk/Timer.hh"
+#include "FbTk/Reactor.hh"
 
 #include <X11/Xutil.h>
 #include <X11/keysym.h>
@@ -38,6 +39,12 @@
 
 using namespace std;
 
+/// wakes up the reactor, the event loop reads the x events itself
+class XConnectionHandler: public FbTk::Reactor::Handler {
+public:
+    void handleFd(int) { }
+};
+
 class App:public FbTk::App, public FbTk::EventHandler {
 public:
     App(const char *displayname):
@@ -71,14 +78,17 @@ public:
     }
     void eventLoop() {
         XEvent ev;
+        XConnectionHandler x_connection;
+        FbTk::Reactor::add(ConnectionNumber(display()), x_connection);
         while (!done()) {
             if (XPending(display())) {
                 XNextEvent(display(), &ev);
                 FbTk::EventManager::instance()->handleEvent(ev);
             } else {
-                FbTk::Timer::updateTimers(ConnectionNumber(display()));
+                FbTk::Reactor::dispatch(true);
             }
         }
+        FbTk::Reactor::remove(ConnectionNumber(display()));
     }
     void exposeEvent(XExposeEvent &event) {
         redraw();
@@ -0,0 +1,187 @@
+// testFrameIndex.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+// adds, moves and removes frames in a FrameIndex at random and compares
+// each query with a scan over all frames. The index never looks at the
+// windows, so they are stand-ins here.
+
+#include "FrameIndex.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+class FluxboxWindow { };
+class Workspace { };
+
+namespace {
+
+const int NR_WINDOWS = 64;
+const int NR_WORKSPACES = 3;
+// a cell of the index, results may hold frames this close to the area
+const int NEAR = 256;
+
+struct Frame {
+    int workspace;
+    unsigned long serial;
+    int left, top, right, bottom;
+};
+
+typedef map<FluxboxWindow *, Frame> Frames;
+
+bool overlaps(const Frame &frame, int left, int top, int right, int bottom) {
+    return frame.left <= right && left <= frame.right &&
+        frame.top <= bottom && top <= frame.bottom;
+}
+
+// anywhere from just off the head to far across it
+void randomBounds(Frame &frame) {
+    frame.left = rand() % 4000 - 1000;
+    frame.top = rand() % 3000 - 1000;
+    frame.right = frame.left + rand() % 800;
+    frame.bottom = frame.top + rand() % 600;
+}
+
+// small moves mostly stay in their cells, larger ones cross some
+void moveBounds(Frame &frame) {
+    int range = rand() % 2 ? 8 : 600;
+    int dx = rand() % (2 * range + 1) - range;
+    int dy = rand() % (2 * range + 1) - range;
+    frame.left += dx;
+    frame.right += dx;
+    frame.top += dy;
+    frame.bottom += dy;
+}
+
+bool testQuery(const FrameIndex &index, const Frames &frames,
+               const Workspace *workspaces, int workspace) {
+
+    int left = rand() % 4000 - 1000;
+    int top = rand() % 3000 - 1000;
+    int right = left + rand() % 1000;
+    int bottom = top + rand() % 1000;
+
+    FrameIndex::Windows found;
+    index.find(workspaces[workspace], left, top, right, bottom, found);
+
+    // in the order of adding, each once, only near ones of the workspace
+    map<FluxboxWindow *, bool> seen;
+    unsigned long last_serial = 0;
+    for (size_t i = 0; i < found.size(); ++i) {
+        Frames::const_iterator it = frames.find(found[i]);
+        if (it == frames.end() || it->second.workspace != workspace ||
+            seen[found[i]] || (i > 0 && it->second.serial <= last_serial) ||
+            !overlaps(it->second, left - NEAR, top - NEAR, right + NEAR, bottom + NEAR)) {
+            cerr << "found a frame it shouldn't have" << endl;
+            return false;
+        }
+        seen[found[i]] = true;
+        last_serial = it->second.serial;
+    }
+
+    Frames::const_iterator it = frames.begin();
+    for (; it != frames.end(); ++it) {
+        if (it->second.workspace == workspace &&
+            overlaps(it->second, left, top, right, bottom) && !seen[it->first]) {
+            cerr << "missed a frame at " << it->second.left << "," << it->second.top
+                 << " in " << left << "," << top << " - " << right << "," << bottom << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool testIndex(int nr_ops) {
+
+    FluxboxWindow windows[NR_WINDOWS];
+    Workspace workspaces[NR_WORKSPACES];
+    FrameIndex index;
+    Frames frames;
+    unsigned long serial = 0;
+
+    for (int op = 0; op < nr_ops; ++op) {
+        FluxboxWindow *win = &windows[rand() % NR_WINDOWS];
+        Frames::iterator it = frames.find(win);
+
+        switch (rand() % 8) {
+        case 0: // (re)added, maybe to another workspace
+        case 1: {
+            Frame frame;
+            frame.workspace = rand() % NR_WORKSPACES;
+            frame.serial = serial++;
+            randomBounds(frame);
+            frames[win] = frame;
+            index.add(*win, workspaces[frame.workspace],
+                      frame.left, frame.top, frame.right, frame.bottom);
+            break;
+        }
+        case 2:
+            if (it != frames.end())
+                frames.erase(it);
+            index.remove(*win);
+            break;
+        case 3: // moves of windows which aren't indexed are ignored
+        case 4:
+        case 5: {
+            Frame frame = it != frames.end() ? it->second : Frame();
+            moveBounds(frame);
+            if (it != frames.end())
+                it->second = frame;
+            index.update(*win, frame.left, frame.top, frame.right, frame.bottom);
+            break;
+        }
+        default:
+            if (!testQuery(index, frames, workspaces, rand() % NR_WORKSPACES))
+                return false;
+            break;
+        }
+    }
+
+    // empties the index again
+    for (int i = 0; i < NR_WINDOWS; ++i)
+        index.remove(windows[i]);
+    FrameIndex::Windows found;
+    for (int i = 0; i < NR_WORKSPACES; ++i) {
+        index.find(workspaces[i], -100000, -100000, 100000, 100000, found);
+        if (!found.empty()) {
+            cerr << "frames left after removing all windows" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    srand(1);
+
+    check(testIndex(200000), "queries against a scan of all frames");
+
+    return TestUtil::report("frameindex");
+}
@@ -0,0 +1,309 @@
+// testFreeSpace.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// checks FreeSpace against the window placement it replaced, with rows
+// and columns in all four directions.
+//
+// usage: testFreeSpace [windows]
+// With a number, also compares the time both need to place that many
+// windows on one head.
+
+#include "FreeSpace.hh"
+#include "FbTk/FbTime.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <set>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+struct Rect {
+    int left, top, right, bottom;
+};
+
+const int HEAD_W = 1920;
+const int HEAD_H = 1080;
+
+int64_t overlap(const vector<Rect> &windows, int x, int y, int w, int h) {
+    int64_t area = 0;
+    for (size_t i = 0; i < windows.size(); ++i) {
+        int right = min(windows[i].right, x + w);
+        int bottom = min(windows[i].bottom, y + h);
+        int left = max(windows[i].left, x);
+        int top = max(windows[i].top, y);
+        if (right > left && bottom > top)
+            area += int64_t(right - left) * (bottom - top);
+    }
+    return area;
+}
+
+// the row by row search of RowSmartPlacement before FreeSpace
+bool oldRowSmart(const vector<Rect> &windows, int head_right, int head_bot,
+                 bool left_right, bool top_bot,
+                 int win_w, int win_h, int &place_x, int &place_y) {
+
+    const int head_left = 0, head_top = 0;
+    const int change_x = left_right ? 1 : -1;
+    bool placed = false;
+    int next_x, next_y;
+
+    int test_y = top_bot ? head_top : head_bot - win_h;
+    while (!placed && (top_bot ? test_y + win_h <= head_bot : test_y >= head_top)) {
+
+        int test_x = left_right ? head_left : head_right - win_w;
+        next_y = top_bot ? head_bot : head_top - 1;
+
+        while (!placed && (left_right ? test_x + win_w <= head_right : test_x >= head_left)) {
+            placed = true;
+            next_x = test_x + change_x;
+
+            for (size_t i = 0; i < windows.size() && placed; ++i) {
+                int curr_x = windows[i].left, curr_y = windows[i].top;
+                int curr_w = windows[i].right - curr_x, curr_h = windows[i].bottom - curr_y;
+                if (curr_x < test_x + win_w && curr_x + curr_w > test_x &&
+                    curr_y < test_y + win_h && curr_y + curr_h > test_y) {
+                    placed = false;
+                    if (left_right) {
+                        if (curr_x + curr_w > next_x)
+                            next_x = curr_x + curr_w;
+                    } else if (curr_x - win_w < next_x)
+                        next_x = curr_x - win_w;
+                    if (top_bot) {
+                        if (curr_y + curr_h < next_y)
+                            next_y = curr_y + curr_h;
+                    } else if (curr_y - win_h > next_y)
+                        next_y = curr_y - win_h;
+                }
+            }
+
+            if (placed) {
+                place_x = test_x;
+                place_y = test_y;
+                break;
+            }
+            test_x = next_x;
+        }
+        test_y = next_y;
+    }
+    return placed;
+}
+
+// ColSmartPlacement searched the same way, column by column
+bool oldSmart(const vector<Rect> &windows, bool rows, bool left_right, bool top_bot,
+              int win_w, int win_h, int &place_x, int &place_y) {
+
+    if (rows)
+        return oldRowSmart(windows, HEAD_W, HEAD_H, left_right, top_bot,
+                           win_w, win_h, place_x, place_y);
+
+    vector<Rect> transposed(windows);
+    for (size_t i = 0; i < transposed.size(); ++i) {
+        swap(transposed[i].left, transposed[i].top);
+        swap(transposed[i].right, transposed[i].bottom);
+    }
+    return oldRowSmart(transposed, HEAD_H, HEAD_W, top_bot, left_right,
+                       win_h, win_w, place_y, place_x);
+}
+
+// the corners MinOverlapPlacement tried before FreeSpace (row policy,
+// left to right, top to bottom)
+struct Area {
+    Area(int corner_, int x_, int y_): corner(corner_), x(x_), y(y_) { }
+    bool operator < (const Area &o) const {
+        if (y != o.y)
+            return y < o.y;
+        if (x != o.x)
+            return x < o.x;
+        return corner < o.corner;
+    }
+    int corner, x, y;
+};
+
+int64_t oldMinOverlap(const vector<Rect> &windows, int win_w, int win_h) {
+
+    set<Area> areas;
+    areas.insert(Area(0, 0, 0));
+    areas.insert(Area(1, HEAD_W - win_w, 0));
+    areas.insert(Area(2, 0, HEAD_H - win_h));
+    areas.insert(Area(3, HEAD_W - win_w, HEAD_H - win_h));
+
+    for (size_t i = windows.size(); i-- > 0; ) {
+        const Rect &r = windows[i];
+        for (set<Area>::iterator it = areas.begin(); it != areas.end(); ++it) {
+            switch (it->corner) {
+            case 0:
+                if (r.right > it->x && r.bottom > it->y) {
+                    if (r.bottom + win_h <= HEAD_H)
+                        areas.insert(Area(0, it->x, r.bottom));
+                    if (r.right + win_w <= HEAD_W)
+                        areas.insert(Area(0, r.right, it->y));
+                }
+                break;
+            case 1:
+                if (r.left < it->x + win_w && r.bottom > it->y) {
+                    if (r.bottom + win_h <= HEAD_H)
+                        areas.insert(Area(1, it->x, r.bottom));
+                    if (r.left - win_w >= 0)
+                        areas.insert(Area(1, r.left - win_w, it->y));
+                }
+                break;
+            case 3:
+                if (r.left < it->x + win_w && r.top < it->y + win_h) {
+                    if (r.top - win_h >= 0)
+                        areas.insert(Area(3, it->x, r.top - win_h));
+                    if (r.left - win_w >= 0)
+                        areas.insert(Area(3, r.left - win_w, it->y));
+                }
+                break;
+            case 2:
+                if (r.right > it->x && r.top < it->y + win_h) {
+                    if (r.top - win_h >= 0)
+                        areas.insert(Area(2, it->x, r.top - win_h));
+                    if (r.right + win_w <= HEAD_W)
+                        areas.insert(Area(2, r.right, it->y));
+                }
+                break;
+            }
+        }
+    }
+
+    int64_t least = -1;
+    for (set<Area>::iterator it = areas.begin(); it != areas.end() && least != 0; ++it) {
+        int64_t area = overlap(windows, it->x, it->y, win_w, win_h);
+        if (least < 0 || area < least)
+            least = area;
+    }
+    return least;
+}
+
+Rect randomWindow() {
+    Rect r;
+    r.left = r.top = 0;
+    r.right = 60 + rand() % 400;
+    r.bottom = 40 + rand() % 300;
+    return r;
+}
+
+// places nr_windows windows like the row or column smart placement with
+// the min overlap fallback and checks every step against the old search.
+// The least overlap the old corners find doesn't depend on the direction.
+bool testPlacement(size_t nr_windows, bool rows, bool left_right, bool top_bot,
+                   bool check_overlap) {
+
+    vector<Rect> windows;
+    FreeSpace space(0, 0, HEAD_W, HEAD_H, rows, left_right, top_bot);
+    uint64_t fit_usec = 0, old_fit_usec = 0, overlap_usec = 0, old_overlap_usec = 0;
+    size_t fitted = 0;
+    bool ok = true;
+
+    for (size_t i = 0; i < nr_windows; ++i) {
+        Rect win = randomWindow();
+        int w = win.right, h = win.bottom;
+        int x = 0, y = 0, old_x = 0, old_y = 0;
+
+        uint64_t start = FbTk::FbTime::mono();
+        bool fits = space.firstFit(w, h, x, y);
+        fit_usec += FbTk::FbTime::mono() - start;
+
+        start = FbTk::FbTime::mono();
+        bool old_fits = oldSmart(windows, rows, left_right, top_bot, w, h, old_x, old_y);
+        old_fit_usec += FbTk::FbTime::mono() - start;
+
+        if (fits != old_fits || (fits && (x != old_x || y != old_y))) {
+            cerr << "window " << i << " " << w << "x" << h << ": placed at "
+                 << x << "," << y << ", old search: " << old_x << "," << old_y << endl;
+            ok = false;
+        }
+
+        if (fits) {
+            fitted++;
+        } else {
+            start = FbTk::FbTime::mono();
+            int64_t area = space.leastOverlap(w, h, x, y);
+            overlap_usec += FbTk::FbTime::mono() - start;
+
+            if (area != overlap(windows, x, y, w, h)) {
+                cerr << "window " << i << ": wrong overlap " << area << endl;
+                ok = false;
+            }
+            if (check_overlap) {
+                start = FbTk::FbTime::mono();
+                int64_t old_area = oldMinOverlap(windows, w, h);
+                old_overlap_usec += FbTk::FbTime::mono() - start;
+                if (area > old_area) {
+                    cerr << "window " << i << ": overlap " << area
+                         << " worse than " << old_area << endl;
+                    ok = false;
+                }
+            }
+        }
+
+        win.left = x;
+        win.top = y;
+        win.right = x + w;
+        win.bottom = y + h;
+        windows.push_back(win);
+        space.add(win.left, win.top, win.right, win.bottom);
+    }
+
+    cerr << "placement: " << nr_windows << " windows, "
+         << (rows ? "rows, " : "columns, ")
+         << (left_right ? "left to right, " : "right to left, ")
+         << (top_bot ? "top to bottom" : "bottom to top") << endl
+         << "  " << fitted << " without overlap: " << fit_usec
+         << " usec, old search " << old_fit_usec << " usec" << endl
+         << "  " << nr_windows - fitted << " with least overlap: " << overlap_usec << " usec";
+    if (check_overlap)
+        cerr << ", old search " << old_overlap_usec << " usec";
+    cerr << endl;
+
+    return ok;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    srand(1);
+
+    check(testPlacement(50, true, true, true, true), "rows, left to right, top to bottom");
+    check(testPlacement(50, true, false, true, true), "rows, right to left, top to bottom");
+    check(testPlacement(50, true, true, false, true), "rows, left to right, bottom to top");
+    check(testPlacement(50, true, false, false, true), "rows, right to left, bottom to top");
+    check(testPlacement(50, false, true, true, true), "columns, left to right, top to bottom");
+    check(testPlacement(50, false, false, true, true), "columns, right to left, top to bottom");
+    check(testPlacement(50, false, true, false, true), "columns, left to right, bottom to top");
+    check(testPlacement(50, false, false, false, true), "columns, right to left, bottom to top");
+
+    if (argc > 1) {
+        size_t nr_windows = atoi(argv[1]);
+        check(testPlacement(nr_windows, true, true, true, false), "timed rows");
+        check(testPlacement(nr_windows, false, true, true, false), "timed columns");
+    }
+
+    return TestUtil::report("freespace");
+}
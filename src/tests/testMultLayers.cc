@@ -0,0 +1,137 @@
+// testMultLayers.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+// restacks random permutations with FbTk::MultLayers::planRestack and
+// replays the moves on a simulated server stack: the windows must end up
+// in the new order, and only the windows outside the longest run that
+// kept its order may be moved
+
+#include "FbTk/MultLayers.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+typedef FbTk::MultLayers::StackMove StackMove;
+
+// what XConfigureWindow with CWSibling | CWStackMode does to the stack
+void applyMove(vector<Window> &server, const StackMove &move) {
+    server.erase(find(server.begin(), server.end(), move.win));
+    vector<Window>::iterator sibling = find(server.begin(), server.end(), move.sibling);
+    if (move.mode == Below)
+        ++sibling;
+    server.insert(sibling, move.win);
+}
+
+// length of the longest run of windows of last which stack has in the
+// same order, the quadratic way
+size_t longestRun(const vector<Window> &last, const vector<Window> &stack) {
+    vector<size_t> order;
+    for (size_t i = 0; i < last.size(); ++i) {
+        vector<Window>::const_iterator it = find(stack.begin(), stack.end(), last[i]);
+        if (it != stack.end())
+            order.push_back(it - stack.begin());
+    }
+    vector<size_t> run(order.size(), 1);
+    size_t longest = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            if (order[j] < order[i])
+                run[i] = max(run[i], run[j] + 1);
+        }
+        longest = max(longest, run[i]);
+    }
+    return longest;
+}
+
+size_t random(size_t n) {
+    return n ? rand() % n : 0;
+}
+
+// last holds nr_known windows of stack and nr_gone windows which were
+// destroyed since. The other windows are new and wherever the server put them.
+bool testRestack(size_t size, size_t nr_known, size_t nr_gone) {
+
+    vector<Window> stack;
+    for (size_t i = 0; i < size; ++i)
+        stack.push_back(0x1000 + i);
+    random_shuffle(stack.begin(), stack.end(), random);
+
+    vector<Window> last(stack.begin(), stack.begin() + nr_known);
+    for (size_t i = 0; i < nr_gone; ++i)
+        last.push_back(0x8000 + i);
+    random_shuffle(last.begin(), last.end(), random);
+
+    vector<Window> server;
+    for (size_t i = 0; i < last.size(); ++i) {
+        if (last[i] < 0x8000)
+            server.push_back(last[i]);
+    }
+    for (size_t i = nr_known; i < size; ++i)
+        server.insert(server.begin() + random(server.size() + 1), stack[i]);
+
+    vector<StackMove> moves;
+    FbTk::MultLayers::planRestack(last, stack, moves);
+    for (size_t i = 0; i < moves.size(); ++i)
+        applyMove(server, moves[i]);
+
+    size_t expected = size - max(longestRun(last, stack), size_t(size > 0));
+    if (server != stack || moves.size() != expected) {
+        cerr << size << " windows, " << nr_known << " known, " << nr_gone
+             << " gone: " << moves.size() << " moves instead of " << expected
+             << (server != stack ? ", wrong order" : "") << endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    srand(1);
+
+    bool ok = true;
+    for (int i = 0; i < 1000 && ok; ++i) {
+        size_t size = random(60);
+        ok = testRestack(size, size, 0);
+    }
+    check(ok, "permutations");
+
+    ok = true;
+    for (int i = 0; i < 1000 && ok; ++i) {
+        size_t size = random(60);
+        ok = testRestack(size, random(size + 1), random(5));
+    }
+    check(ok, "new and destroyed windows");
+
+    check(testRestack(1, 0, 0) && testRestack(0, 0, 3), "nothing known");
+
+    return TestUtil::report("multlayers");
+}
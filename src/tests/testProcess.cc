@@ -0,0 +1,140 @@
+// testProcess.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// checks FbTk::Process::spawnShell: environment, session, exit status.
+//
+// usage: testProcess [megabytes]
+// With a size, also times how long the caller is held up launching a
+// command, against fork and exec as ExecuteCmd used to do, with that much
+// resident, like a window manager with big pixmap caches (e.g. 256).
+
+#include "FbTk/Process.hh"
+#include "FbTk/FbTime.hh"
+#include "TestUtil.hh"
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+int exitStatus(pid_t pid) {
+    int status = 0;
+    if (pid <= 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+        return -1;
+    return WEXITSTATUS(status);
+}
+
+void testSpawn() {
+    setenv("SHELL", "/bin/sh", 1);
+    setenv("DISPLAY", ":0.0", 1);
+    setenv("TEST_PROCESS_KEEP", "yes", 1);
+
+    vector<string> env;
+    env.push_back("DISPLAY=:7.1");
+    pid_t pid = FbTk::Process::spawnShell(
+        "test \"$DISPLAY\" = :7.1 && test \"$TEST_PROCESS_KEEP\" = yes", env);
+    check(exitStatus(pid) == 0, "environment replaced and kept");
+    check(strcmp(getenv("DISPLAY"), ":0.0") == 0, "own environment untouched");
+
+    env.push_back("TEST_PROCESS_NEW=1");
+    pid = FbTk::Process::spawnShell("test \"$TEST_PROCESS_NEW\" = 1", env);
+    check(exitStatus(pid) == 0, "environment added to");
+
+    // the session id is the 6th field, the child leads its own session
+    pid = FbTk::Process::spawnShell(
+        "test ! -r /proc/$$/stat || test `cut -d' ' -f6 /proc/$$/stat` = $$", env);
+    check(exitStatus(pid) == 0, "new session");
+
+    pid = FbTk::Process::spawnShell("exit 3", env);
+    check(exitStatus(pid) == 3, "command run by the shell");
+
+    // either not started or the child gives up without running anything
+    setenv("SHELL", "/nonexistent/sh", 1);
+    pid = FbTk::Process::spawnShell("exit 0", env);
+    check(pid < 0 || exitStatus(pid) == 127, "missing shell");
+    setenv("SHELL", "/bin/sh", 1);
+}
+
+// what ExecuteCmd::run did before
+pid_t forkShell(const string &command, const string &display) {
+    pid_t pid = fork();
+    if (pid)
+        return pid;
+    setenv("DISPLAY", display.c_str(), 1);
+    const char *shell = getenv("SHELL");
+    setsid();
+    execl(shell, shell, "-c", command.c_str(), static_cast<void*>(NULL));
+    exit(EXIT_SUCCESS);
+}
+
+void benchmark(size_t megabytes) {
+    const int LAUNCHES = 200;
+
+    // touched, so it's resident and mapped by page tables fork copies
+    vector<char> resident(megabytes << 20);
+    for (size_t i = 0; i < resident.size(); i += 4096)
+        resident[i] = char(i);
+
+    vector<string> env(1, "DISPLAY=:0.1");
+    uint64_t fork_stall = 0, fork_total = 0;
+    uint64_t spawn_stall = 0, spawn_total = 0;
+
+    for (int i = 0; i < LAUNCHES; ++i) {
+        uint64_t start = FbTk::FbTime::mono();
+        pid_t pid = forkShell("true", ":0.1");
+        fork_stall += FbTk::FbTime::mono() - start;
+        check(exitStatus(pid) == 0, "fork launch");
+        fork_total += FbTk::FbTime::mono() - start;
+
+        start = FbTk::FbTime::mono();
+        pid = FbTk::Process::spawnShell("true", env);
+        spawn_stall += FbTk::FbTime::mono() - start;
+        check(exitStatus(pid) == 0, "spawn launch");
+        spawn_total += FbTk::FbTime::mono() - start;
+    }
+
+    cerr << "launching " << LAUNCHES << " times with " << megabytes
+         << " MB resident, per launch: caller held up / until exit" << endl
+         << "  fork:        " << fork_stall / LAUNCHES << " / "
+         << fork_total / LAUNCHES << " usec" << endl
+         << "  spawnShell:  " << spawn_stall / LAUNCHES << " / "
+         << spawn_total / LAUNCHES << " usec" << endl;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    testSpawn();
+    if (argc > 1)
+        benchmark(atoi(argv[1]));
+
+    return TestUtil::report("process");
+}
@@ -0,0 +1,235 @@
+// testPropertySnapshot.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// checks that FbTk::PropertySnapshot hands out what XGetWindowProperty
+// does, for all lengths and types asked for, and times reading the
+// properties fluxbox reads when adopting a window one by one and through
+// a snapshot. Needs a display; the difference shows over a slow link, e.g.
+// run it against a display forwarded through ssh.
+//
+// usage: testPropertySnapshot [display]
+
+#include "FbTk/PropertySnapshot.hh"
+#include "FbTk/FbTime.hh"
+#include "TestUtil.hh"
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+const char *s_atom_names[] = {
+    "WM_PROTOCOLS", "WM_STATE", "WM_WINDOW_ROLE", "_MOTIF_WM_HINTS",
+    "_FLUXBOX_GROUP_LEFT", "_NET_WM_NAME", "_NET_WM_ICON",
+    "_NET_WM_WINDOW_TYPE", "_NET_WM_STRUT", "_NET_WM_DESKTOP",
+    "_NET_WM_STATE", "UTF8_STRING", "_TEST_SHORTS"
+};
+
+enum {
+    WM_PROTOCOLS, WM_STATE, WM_WINDOW_ROLE, MOTIF_WM_HINTS,
+    FLUXBOX_GROUP_LEFT, NET_WM_NAME, NET_WM_ICON,
+    NET_WM_WINDOW_TYPE, NET_WM_STRUT, NET_WM_DESKTOP,
+    NET_WM_STATE, UTF8_STRING, TEST_SHORTS, NR_ATOMS
+};
+
+// sets what a typical client has before mapping
+void setProperties(Display *disp, Window win, Atom *atoms) {
+    XStoreName(disp, win, "xterm");
+    XChangeProperty(disp, win, XA_WM_CLASS, XA_STRING, 8, PropModeReplace,
+                    (unsigned char *)"xterm\0XTerm", 12);
+    XChangeProperty(disp, win, atoms[NET_WM_NAME], atoms[UTF8_STRING], 8,
+                    PropModeReplace, (unsigned char *)"xterm \xc3\xa4", 8);
+
+    Atom protocols[] = { XInternAtom(disp, "WM_DELETE_WINDOW", False) };
+    XSetWMProtocols(disp, win, protocols, 1);
+
+    XWMHints hints;
+    hints.flags = InputHint | StateHint;
+    hints.input = True;
+    hints.initial_state = NormalState;
+    XSetWMHints(disp, win, &hints);
+
+    XSizeHints size;
+    size.flags = PMinSize | PResizeInc | PBaseSize;
+    size.min_width = size.min_height = 10;
+    size.width_inc = 6;
+    size.height_inc = 13;
+    size.base_width = size.base_height = 4;
+    XSetWMNormalHints(disp, win, &size);
+
+    long desktop = 0xffffffff;
+    XChangeProperty(disp, win, atoms[NET_WM_DESKTOP], XA_CARDINAL, 32,
+                    PropModeReplace, (unsigned char *)&desktop, 1);
+
+    vector<long> icon(2 + 48 * 48, 0xff336699);
+    icon[0] = icon[1] = 48;
+    XChangeProperty(disp, win, atoms[NET_WM_ICON], XA_CARDINAL, 32,
+                    PropModeReplace, (unsigned char *)&icon[0], icon.size());
+
+    short shorts[] = { -1, 2, -3 };
+    XChangeProperty(disp, win, atoms[TEST_SHORTS], XA_INTEGER, 16,
+                    PropModeReplace, (unsigned char *)shorts, 3);
+}
+
+bool compare(Display *disp, Window win, const FbTk::PropertySnapshot &snapshot,
+             Atom prop, long length, Atom req_type) {
+    Atom type, snap_type;
+    int format, snap_format;
+    unsigned long nitems, snap_nitems, after, snap_after;
+    unsigned char *data = 0, *snap_data = 0;
+
+    if (XGetWindowProperty(disp, win, prop, 0, length, False, req_type,
+                           &type, &format, &nitems, &after, &data) != Success)
+        return true;
+    if (!snapshot.get(prop, length, req_type, &snap_type, &snap_format,
+                      &snap_nitems, &snap_after, &snap_data)) {
+        cerr << "property " << prop << " missing" << endl;
+        return false;
+    }
+
+    size_t size = format == 32 ? sizeof(long) : format == 16 ? sizeof(short) : 1;
+    bool ok = type == snap_type && format == snap_format &&
+        nitems == snap_nitems && after == snap_after &&
+        (data == 0) == (snap_data == 0) &&
+        (data == 0 || memcmp(data, snap_data, nitems * size + 1) == 0);
+    if (!ok) {
+        cerr << "property " << prop << ", length " << length << ", type "
+             << req_type << ": got " << snap_type << "/" << snap_format << "/"
+             << snap_nitems << "/" << snap_after << " instead of " << type
+             << "/" << format << "/" << nitems << "/" << after << endl;
+    }
+
+    if (data != 0)
+        XFree(data);
+    if (snap_data != 0)
+        XFree(snap_data);
+    return ok;
+}
+
+bool testValues(Display *disp, Window win, const vector<Atom> &atoms) {
+    FbTk::PropertySnapshot snapshot(disp, win);
+    snapshot.fetch(&atoms[0], atoms.size());
+
+    const long lengths[] = { 0, 1, 2, 3, 4, 1000000, 0x7fffffff };
+    const Atom types[] = { AnyPropertyType, XA_STRING, XA_CARDINAL, XA_INTEGER };
+    bool ok = true;
+    for (size_t a = 0; a < atoms.size(); ++a) {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+            for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t)
+                ok = compare(disp, win, snapshot, atoms[a], lengths[l], types[t]) && ok;
+        }
+    }
+
+    snapshot.forget(XA_WM_NAME);
+    Atom type;
+    int format;
+    unsigned long nitems, after;
+    unsigned char *data = 0;
+    if (snapshot.get(XA_WM_NAME, 100, AnyPropertyType, &type, &format,
+                     &nitems, &after, &data)) {
+        cerr << "forgotten property still there" << endl;
+        ok = false;
+    }
+    return ok;
+}
+
+void readEach(Display *disp, Window win, const vector<Atom> &atoms) {
+    for (size_t i = 0; i < atoms.size(); ++i) {
+        Atom type;
+        int format;
+        unsigned long nitems, after;
+        unsigned char *data = 0;
+        if (XGetWindowProperty(disp, win, atoms[i], 0, 0x7fffffff, False,
+                               AnyPropertyType, &type, &format, &nitems,
+                               &after, &data) == Success && data != 0)
+            XFree(data);
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    Display *disp = XOpenDisplay(argc > 1 ? argv[1] : 0);
+    if (disp == 0) {
+        cerr << "can't open display" << endl;
+        return EXIT_FAILURE;
+    }
+
+    Atom atoms[NR_ATOMS];
+    XInternAtoms(disp, const_cast<char **>(s_atom_names), NR_ATOMS, False, atoms);
+
+    const int NR_WINDOWS = 200;
+    vector<Window> windows;
+    for (int i = 0; i < NR_WINDOWS; ++i) {
+        windows.push_back(XCreateSimpleWindow(disp, DefaultRootWindow(disp),
+                                              0, 0, 100, 100, 0, 0, 0));
+        setProperties(disp, windows.back(), atoms);
+    }
+    XSync(disp, False);
+
+    // what WinClient asks for, a property set twice and one nobody has
+    vector<Atom> adopted(atoms, atoms + NET_WM_STATE + 1);
+    adopted.push_back(XA_WM_NAME);
+    adopted.push_back(XA_WM_CLASS);
+    adopted.push_back(XA_WM_HINTS);
+    adopted.push_back(XA_WM_NORMAL_HINTS);
+    adopted.push_back(XA_WM_TRANSIENT_FOR);
+
+    vector<Atom> checked(adopted);
+    checked.push_back(atoms[TEST_SHORTS]);
+    checked.push_back(XA_WM_CLASS);
+    checked.push_back(XA_WM_ICON_NAME);
+
+    check(testValues(disp, windows[0], checked), "snapshot values");
+
+    uint64_t start = FbTk::FbTime::mono();
+    for (int i = 0; i < NR_WINDOWS; ++i)
+        readEach(disp, windows[i], adopted);
+    uint64_t each_usec = FbTk::FbTime::mono() - start;
+
+    start = FbTk::FbTime::mono();
+    for (int i = 0; i < NR_WINDOWS; ++i) {
+        FbTk::PropertySnapshot snapshot(disp, windows[i]);
+        snapshot.fetch(&adopted[0], adopted.size());
+    }
+    uint64_t snapshot_usec = FbTk::FbTime::mono() - start;
+
+    cerr << "reading " << adopted.size() << " properties of "
+         << NR_WINDOWS << " windows" << endl
+         << "  one by one:  " << each_usec << " usec" << endl
+         << "  snapshot:    " << snapshot_usec << " usec" << endl;
+
+    for (int i = 0; i < NR_WINDOWS; ++i)
+        XDestroyWindow(disp, windows[i]);
+    XCloseDisplay(disp);
+
+    return TestUtil::report("propertysnapshot");
+}
@@ -0,0 +1,128 @@
+// testShape.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+
+// checks the rectangles FbTk::Shape rounds windows off with against the
+// 8x8 corner masks it used to subtract, for boxes down to a single pixel
+
+#include "FbTk/Shape.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+// set bits are kept, as in the old corner pixmaps
+const unsigned char left_bits[] = { 0xc0, 0xf8, 0xfc, 0xfe, 0xfe, 0xfe, 0xff, 0xff };
+const unsigned char right_bits[] = { 0x03, 0x1f, 0x3f, 0x7f, 0x7f, 0x7f, 0xff, 0xff };
+const unsigned char bottom_left_bits[] = { 0xff, 0xff, 0xfe, 0xfe, 0xfe, 0xfc, 0xf8, 0xc0 };
+const unsigned char bottom_right_bits[] = { 0xff, 0xff, 0x7f, 0x7f, 0x7f, 0x3f, 0x1f, 0x03 };
+
+void subtractCorner(vector<char> &pixels, int width, int height,
+                    int x, int y, const unsigned char rows[]) {
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            int px = x + col, py = y + row;
+            if ((rows[row] & (0x01 << col)) == 0 &&
+                px >= 0 && px < width && py >= 0 && py < height)
+                pixels[py * width + px] = 0;
+        }
+    }
+}
+
+bool checkBox(int width, int height, int places) {
+    vector<char> expected(width * height, 1);
+    if (places & FbTk::Shape::TOPLEFT)
+        subtractCorner(expected, width, height, 0, 0, left_bits);
+    if (places & FbTk::Shape::TOPRIGHT)
+        subtractCorner(expected, width, height, width - 8, 0, right_bits);
+    if (places & FbTk::Shape::BOTTOMLEFT)
+        subtractCorner(expected, width, height, 0, height - 8, bottom_left_bits);
+    if (places & FbTk::Shape::BOTTOMRIGHT)
+        subtractCorner(expected, width, height, width - 8, height - 8, bottom_right_bits);
+
+    // off the origin, like the bounding shape
+    const int X = -3, Y = -2;
+    vector<XRectangle> rects;
+    FbTk::Shape::roundedBox(X, Y, width, height, places, rects);
+
+    vector<char> got(width * height, 0);
+    for (size_t i = 0; i < rects.size(); ++i) {
+        const XRectangle &r = rects[i];
+        if (r.width == 0 || r.height == 0 ||
+            r.x < X || r.y < Y || r.x - X + r.width > width || r.y - Y + r.height > height) {
+            cerr << width << "x" << height << ": rectangle " << i << " out of the box" << endl;
+            return false;
+        }
+        if (i > 0 && r.y < rects[i-1].y + rects[i-1].height) {
+            cerr << width << "x" << height << ": rectangle " << i << " not banded" << endl;
+            return false;
+        }
+        for (int y = r.y - Y; y < r.y - Y + r.height; ++y) {
+            for (int x = r.x - X; x < r.x - X + r.width; ++x) {
+                if (got[y * width + x]) {
+                    cerr << width << "x" << height << ": overlap at "
+                         << x << "," << y << endl;
+                    return false;
+                }
+                got[y * width + x] = 1;
+            }
+        }
+    }
+
+    if (got != expected) {
+        cerr << width << "x" << height << " places " << places
+             << ": wrong pixels" << endl;
+        return false;
+    }
+    // 8 rows per rounded side at most, plus the one in between
+    if (rects.size() > 17) {
+        cerr << width << "x" << height << ": " << rects.size() << " rectangles" << endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    const int ALL = FbTk::Shape::TOPLEFT | FbTk::Shape::TOPRIGHT |
+        FbTk::Shape::BOTTOMLEFT | FbTk::Shape::BOTTOMRIGHT;
+
+    bool ok = true;
+    for (int places = 0; places <= ALL && ok; ++places) {
+        for (int width = 1; width < 40 && ok; ++width) {
+            for (int height = 1; height < 40 && ok; ++height)
+                ok = checkBox(width, height, places);
+        }
+    }
+    check(ok, "small boxes");
+    check(checkBox(1280, 1024, ALL), "1280x1024 box");
+    check(checkBox(3840, 21, ALL), "3840x21 box");
+
+    return TestUtil::report("shape");
+}
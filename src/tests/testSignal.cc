@@ -0,0 +1,294 @@
+// testSignal.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// checks FbTk::Signal and SignalTracker, disconnecting and connecting
+// while emitting included, and times connect and emit against a signal
+// holding its slots in a std::list of ref counted slots, as it used to
+
+#include "FbTk/Signal.hh"
+#include "FbTk/MemFun.hh"
+#include "FbTk/FbTime.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <algorithm>
+#include <list>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+struct Counter {
+    Counter(): count(0), sum(0) { }
+    void inc() { ++count; }
+    void add(int value) { ++count; sum += value; }
+    void add3(int a, int b, int c) { ++count; sum += a + b + c; }
+    int count;
+    int sum;
+};
+
+// too big to be kept inline, and counts its copies
+struct BigFunctor {
+    static int s_alive;
+    BigFunctor(int &count): m_count(&count) { ++s_alive; }
+    BigFunctor(const BigFunctor &other): m_count(other.m_count) { ++s_alive; }
+    ~BigFunctor() { --s_alive; }
+    void operator()(int) { ++*m_count; }
+    int *m_count;
+    char m_padding[128];
+};
+int BigFunctor::s_alive = 0;
+
+// disconnects itself, another slot or everything when called
+struct Disconnecter {
+    Disconnecter(FbTk::Signal<int> &sig): m_sig(sig), m_id(0), m_count(0) { }
+    void self(int) { ++m_count; m_sig.disconnect(m_id); }
+    void clear(int) { ++m_count; m_sig.clear(); }
+    void connect(int) { ++m_count; m_sig.connect(FbTk::MemFun(*this, &Disconnecter::self)); }
+    void emitAgain(int depth) { ++m_count; if (depth > 0) m_sig.emit(depth - 1); }
+    FbTk::Signal<int> &m_sig;
+    FbTk::Signal<int>::SlotID m_id;
+    int m_count;
+};
+
+struct Slot1: public FbTk::Slot<void, int> {
+    Slot1(): count(0) { }
+    void operator()(int) { ++count; }
+    int count;
+};
+
+void testEmit() {
+    FbTk::Signal<> sig0;
+    FbTk::Signal<int> sig1;
+    FbTk::Signal<int, int, int> sig3;
+    Counter counter;
+
+    sig0.connect(FbTk::MemFun(counter, &Counter::inc));
+    sig1.connect(FbTk::MemFun(counter, &Counter::add));
+    sig3.connect(FbTk::MemFun(counter, &Counter::add3));
+    sig0.emit();
+    sig1.emit(5);
+    sig3.emit(1, 2, 3);
+    check(counter.count == 3 && counter.sum == 11, "emit with 0, 1 and 3 arguments");
+
+    // spill out of the inline entries and disconnect from the middle
+    Counter counters[5];
+    FbTk::Signal<int>::SlotID ids[5];
+    for (int i = 0; i < 5; ++i)
+        ids[i] = sig1.connect(FbTk::MemFun(counters[i], &Counter::add));
+    sig1.disconnect(ids[1]);
+    sig1.disconnect(ids[3]);
+    sig1.emit(1);
+    check(counters[0].count == 1 && counters[1].count == 0 && counters[2].count == 1 &&
+          counters[3].count == 0 && counters[4].count == 1, "disconnect by id");
+    sig1.disconnect(ids[4]);
+    sig1.emit(1);
+    check(counters[4].count == 1 && counters[2].count == 2, "disconnect the last one");
+
+    int big_count = 0;
+    {
+        FbTk::Signal<int> sig;
+        for (int i = 0; i < 4; ++i)
+            sig.connect(BigFunctor(big_count));
+        sig.emit(0);
+        check(big_count == 4, "functor on the heap");
+    }
+    check(BigFunctor::s_alive == 0, "heap functors destroyed");
+
+    Slot1 *slot = new Slot1;
+    FbTk::RefCount<FbTk::Slot<void, int> > slot_ref(slot);
+    sig1.clear();
+    sig1.connectSlot(slot_ref);
+    sig1.emit(0);
+    check(slot->count == 1, "connectSlot");
+}
+
+void testReentrancy() {
+    FbTk::Signal<int> sig;
+    Counter before, after;
+    Disconnecter dis(sig);
+
+    sig.connect(FbTk::MemFun(before, &Counter::add));
+    dis.m_id = sig.connect(FbTk::MemFun(dis, &Disconnecter::self));
+    sig.connect(FbTk::MemFun(after, &Counter::add));
+    sig.emit(0);
+    sig.emit(0);
+    check(dis.m_count == 1 && before.count == 2 && after.count == 2,
+          "slot disconnecting itself");
+
+    Disconnecter other(sig);
+    FbTk::Signal<int>::SlotID after_id = 0;
+    sig.clear();
+    sig.connect(FbTk::MemFun(other, &Disconnecter::self));
+    after_id = sig.connect(FbTk::MemFun(after, &Counter::add));
+    other.m_id = after_id;
+    sig.emit(0);
+    check(after.count == 2, "later slot disconnected while emitting is skipped");
+
+    Counter untouched;
+    sig.clear();
+    sig.connect(FbTk::MemFun(dis, &Disconnecter::clear));
+    sig.connect(FbTk::MemFun(untouched, &Counter::add));
+    sig.emit(0);
+    sig.emit(0);
+    check(untouched.count == 0 && dis.m_count == 2, "clear while emitting");
+
+    Disconnecter connecter(sig);
+    sig.clear();
+    sig.connect(FbTk::MemFun(connecter, &Disconnecter::connect));
+    sig.emit(0);
+    check(connecter.m_count == 1, "slot connected while emitting waits");
+    sig.emit(0);
+    // the connect slot ran again and the first new one was called
+    check(connecter.m_count == 3, "slot connected while emitting is called later");
+
+    Disconnecter nested(sig);
+    Counter counted;
+    sig.clear();
+    sig.connect(FbTk::MemFun(nested, &Disconnecter::emitAgain));
+    sig.connect(FbTk::MemFun(counted, &Counter::add));
+    sig.emit(3);
+    check(nested.m_count == 4 && counted.count == 4, "nested emit");
+}
+
+void testTracker() {
+    Counter counter;
+    FbTk::Signal<int> sig;
+    {
+        FbTk::SignalTracker tracker;
+        tracker.join(sig, FbTk::MemFun(counter, &Counter::add));
+        sig.emit(1);
+    }
+    sig.emit(1);
+    check(counter.count == 1, "tracker leaves when destroyed");
+
+    FbTk::SignalTracker tracker;
+    {
+        FbTk::Signal<int> short_lived;
+        tracker.join(short_lived, FbTk::MemFun(counter, &Counter::add));
+        tracker.join(sig, FbTk::MemFun(counter, &Counter::add));
+    }
+    sig.emit(1);
+    check(counter.count == 2, "tracker forgets destroyed signals");
+
+    tracker.leave(sig);
+    sig.emit(1);
+    check(counter.count == 2, "tracker leaves a signal");
+
+    FbTk::SignalTracker::TrackID id =
+        tracker.join(sig, FbTk::MemFun(counter, &Counter::add));
+    tracker.join(sig, FbTk::MemFun(counter, &Counter::add));
+    sig.emit(1);
+    check(counter.count == 3, "tracker joins a signal once");
+    tracker.leave(id);
+    sig.emit(1);
+    check(counter.count == 3, "tracker leaves by id");
+}
+
+// the slot storage Signal had before
+struct ListSignal {
+    typedef FbTk::RefCount<FbTk::SigImpl::SlotBase> SlotPtr;
+    typedef std::list<SlotPtr> SlotList;
+
+    template <typename Functor>
+    SlotList::iterator connect(const Functor &functor) {
+        return m_slots.insert(m_slots.end(),
+                SlotPtr(new FbTk::SlotImpl<Functor, void, int>(functor)));
+    }
+    void disconnect(SlotList::iterator it) { m_slots.erase(it); }
+    void emit(int arg) {
+        for (SlotList::iterator it = m_slots.begin(); it != m_slots.end(); ++it) {
+            if (*it)
+                static_cast<FbTk::Slot<void, int> &>(**it)(arg);
+        }
+        m_slots.erase(std::remove(m_slots.begin(), m_slots.end(), SlotPtr()), m_slots.end());
+    }
+
+    SlotList m_slots;
+};
+
+void benchmark() {
+    const int CONNECTS = 1000000;
+    const int EMITS = 5000000;
+    Counter counter;
+
+    uint64_t start = FbTk::FbTime::mono();
+    for (int i = 0; i < CONNECTS; ++i) {
+        FbTk::Signal<int> sig;
+        FbTk::Signal<int>::SlotID id = sig.connect(FbTk::MemFun(counter, &Counter::add));
+        sig.connect(FbTk::MemFun(counter, &Counter::add));
+        sig.disconnect(id);
+    }
+    uint64_t signal_connect = FbTk::FbTime::mono() - start;
+
+    start = FbTk::FbTime::mono();
+    for (int i = 0; i < CONNECTS; ++i) {
+        ListSignal sig;
+        ListSignal::SlotList::iterator id = sig.connect(FbTk::MemFun(counter, &Counter::add));
+        sig.connect(FbTk::MemFun(counter, &Counter::add));
+        sig.disconnect(id);
+    }
+    uint64_t list_connect = FbTk::FbTime::mono() - start;
+
+    cerr << "connect, connect, disconnect, destroy: " << CONNECTS << " times" << endl
+         << "  Signal:     " << signal_connect << " usec" << endl
+         << "  std::list:  " << list_connect << " usec" << endl;
+
+    const int nr_slots[] = { 1, 4, 16 };
+    for (size_t n = 0; n < sizeof(nr_slots) / sizeof(nr_slots[0]); ++n) {
+        FbTk::Signal<int> sig;
+        ListSignal list_sig;
+        Counter counters[16];
+        for (int i = 0; i < nr_slots[n]; ++i) {
+            sig.connect(FbTk::MemFun(counters[i], &Counter::add));
+            list_sig.connect(FbTk::MemFun(counters[i], &Counter::add));
+        }
+
+        start = FbTk::FbTime::mono();
+        for (int i = 0; i < EMITS; ++i)
+            sig.emit(i);
+        uint64_t signal_emit = FbTk::FbTime::mono() - start;
+
+        start = FbTk::FbTime::mono();
+        for (int i = 0; i < EMITS; ++i)
+            list_sig.emit(i);
+        uint64_t list_emit = FbTk::FbTime::mono() - start;
+
+        check(counters[0].count == 2 * EMITS, "benchmark emits");
+        cerr << "emit to " << nr_slots[n] << " slots: " << EMITS << " times" << endl
+             << "  Signal:     " << signal_emit << " usec" << endl
+             << "  std::list:  " << list_emit << " usec" << endl;
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    testEmit();
+    testReentrancy();
+    testTracker();
+    benchmark();
+
+    return TestUtil::report("signal");
+}
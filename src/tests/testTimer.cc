@@ -0,0 +1,131 @@
+// testTimer.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// microbenchmark for FbTk::Timer: start/stop churn and the number of
+// wake-ups needed for a burst of timers, with and without slack
+
+#include "FbTk/Timer.hh"
+#include "FbTk/FbTime.hh"
+#include "FbTk/Reactor.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using TestUtil::check;
+using namespace FbTk;
+
+namespace {
+
+unsigned int s_fired = 0;
+unsigned int s_early = 0;
+
+struct CountFire {
+    CountFire(const Timer *timer): m_timer(timer) { }
+    void operator()() const {
+        if (FbTime::mono() < m_timer->getEndTime())
+            s_early++;
+        s_fired++;
+    }
+    const Timer *m_timer;
+};
+
+struct Nothing {
+    void operator()() const { }
+};
+
+void testChurn(size_t nr_timers, size_t nr_ops) {
+
+    vector<Timer *> timers;
+    for (size_t i = 0; i < nr_timers; ++i) {
+        Timer *timer = new Timer();
+        timer->setFunctor(Nothing());
+        timer->setTimeout(FbTime::IN_SECONDS + (rand() % 10000) * FbTime::IN_MILLISECONDS);
+        timer->start();
+        timers.push_back(timer);
+    }
+
+    uint64_t start = FbTime::mono();
+    for (size_t i = 0; i < nr_ops; ++i) {
+        Timer *timer = timers[rand() % nr_timers];
+        if (timer->isTiming())
+            timer->stop();
+        else
+            timer->start();
+    }
+    uint64_t usec = FbTime::mono() - start;
+
+    cerr << "churn: " << nr_ops << " start/stop on " << nr_timers << " timers: "
+         << usec << " usec (" << (usec * 1000.0 / nr_ops) << " nsec/op)" << endl;
+
+    for (size_t i = 0; i < nr_timers; ++i)
+        delete timers[i];
+}
+
+// starts nr_timers timers that end spread_usec apart and counts the
+// wake-ups needed to handle them all
+bool testWakeups(size_t nr_timers, uint64_t spread_usec, uint64_t slack) {
+
+    Timer::setSlack(slack);
+    s_fired = s_early = 0;
+
+    vector<Timer *> timers;
+    for (size_t i = 0; i < nr_timers; ++i) {
+        Timer *timer = new Timer();
+        timer->setFunctor(CountFire(timer));
+        timer->setTimeout(5 * FbTime::IN_MILLISECONDS + i * spread_usec);
+        timer->fireOnce(true);
+        timers.push_back(timer);
+    }
+    for (size_t i = 0; i < nr_timers; ++i)
+        timers[i]->start();
+
+    unsigned int wakeups = 0;
+    while (s_fired < nr_timers) {
+        Reactor::dispatch(true);
+        wakeups++;
+    }
+
+    cerr << "wakeups: " << nr_timers << " timers, " << spread_usec
+         << " usec apart, slack " << slack << " usec: "
+         << wakeups << " wake-ups, " << s_early << " fired early" << endl;
+
+    for (size_t i = 0; i < nr_timers; ++i)
+        delete timers[i];
+
+    return s_early == 0;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    testChurn(1000, 1000000);
+    testChurn(10000, 1000000);
+
+    check(testWakeups(100, 500, 0), "wake-ups without slack");
+    check(testWakeups(100, 500, 2 * FbTime::IN_MILLISECONDS), "wake-ups with 2ms slack");
+    check(testWakeups(100, 500, 10 * FbTime::IN_MILLISECONDS), "wake-ups with 10ms slack");
+
+    return TestUtil::report("timer");
+}
@@ -0,0 +1,256 @@
+// testWindowMap.cc
+// Copyright (c) 2026 Fluxbox Team (fluxgen at fluxbox dot org)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+
+// checks FbTk::WindowMap against std::map and replays an event stream
+// through both the way EventManager::dispatch looks up handlers.
+//
+// usage: testWindowMap [stream]
+// stream has one event per line, "<type> <window> <parent>" with the
+// windows in hex. Without one, a stream shaped like a recorded session is
+// generated: 200 frames of 13 windows each, mostly runs of MotionNotify
+// over titlebars with crossings and exposes in between.
+
+#include "FbTk/WindowMap.hh"
+#include "FbTk/FbTime.hh"
+#include "TestUtil.hh"
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+using TestUtil::check;
+
+namespace {
+
+struct Handler {
+    Handler(): count(0) { }
+    unsigned long count;
+};
+
+struct Event {
+    int type;
+    Window win;
+    Window parent;
+};
+
+bool testAgainstMap() {
+    FbTk::WindowMap<Handler> table;
+    map<Window, Handler *> reference;
+    vector<Handler> handlers(16);
+    vector<Window> used;
+    bool ok = true;
+
+    for (int op = 0; op < 200000 && ok; ++op) {
+        Window win;
+        // mostly windows seen before, so erase and replace get exercised
+        if (used.empty() || rand() % 3 == 0) {
+            win = 0x00600000 + rand() % 4096;
+            used.push_back(win);
+        } else
+            win = used[rand() % used.size()];
+
+        Handler *handler = &handlers[rand() % handlers.size()];
+        if (rand() % 5 < 3) {
+            table.insert(win, handler);
+            reference[win] = handler;
+        } else {
+            table.erase(win);
+            reference.erase(win);
+        }
+
+        // find twice, to go through the last hit as well
+        Window probe = used[rand() % used.size()];
+        map<Window, Handler *>::iterator it = reference.find(probe);
+        Handler *expected = it == reference.end() ? 0 : it->second;
+        if (table.find(probe) != expected || table.find(probe) != expected) {
+            cerr << "op " << op << ": wrong handler for " << hex << probe << dec << endl;
+            ok = false;
+        }
+        if (table.size() != reference.size()) {
+            cerr << "op " << op << ": size " << table.size()
+                 << " instead of " << reference.size() << endl;
+            ok = false;
+        }
+    }
+
+    for (map<Window, Handler *>::iterator it = reference.begin();
+         ok && it != reference.end(); ++it) {
+        if (table.find(it->first) != it->second) {
+            cerr << "lost " << hex << it->first << dec << endl;
+            ok = false;
+        }
+    }
+
+    if (table.find(None) != 0) {
+        cerr << "found a handler for None" << endl;
+        ok = false;
+    }
+
+    return ok;
+}
+
+// windows of one frame: frame, titlebar, label, tab, five buttons,
+// handle, two grips and the client, which belongs to another connection
+void generateStream(vector<Event> &stream, vector<Window> &windows,
+                    vector<Window> &parents) {
+    const int NR_FRAMES = 200;
+    const int NR_SUBWINDOWS = 12;
+    Window next_id = 0x00600005;
+
+    vector<Window> frames;
+    vector<vector<Window> > subwindows(NR_FRAMES);
+    for (int f = 0; f < NR_FRAMES; ++f) {
+        Window frame = next_id++;
+        frames.push_back(frame);
+        windows.push_back(frame);
+        for (int s = 0; s < NR_SUBWINDOWS - 1; ++s) {
+            subwindows[f].push_back(next_id++);
+            windows.push_back(subwindows[f].back());
+        }
+        Window client = 0x01a00003 + (Window(f) << 21);
+        subwindows[f].push_back(client);
+        windows.push_back(client);
+        // throwaway windows (menus, tooltips) take ids in between
+        next_id += rand() % 4;
+    }
+    // the toolbar listens to its children, as in fluxbox
+    parents.push_back(next_id);
+
+    while (stream.size() < 2000000) {
+        int f = rand() % 20 == 0 ? rand() % NR_FRAMES : rand() % 10;
+        // titlebar, label, tab and buttons get most of the pointer
+        Window win = subwindows[f][rand() % 8];
+        Event ev;
+        ev.win = win;
+        ev.parent = frames[f];
+
+        ev.type = EnterNotify;
+        stream.push_back(ev);
+        ev.type = MotionNotify;
+        for (int m = 5 + rand() % 60; m > 0; --m)
+            stream.push_back(ev);
+        if (rand() % 4 == 0) {
+            ev.type = Expose;
+            for (int e = 1 + rand() % 4; e > 0; --e)
+                stream.push_back(ev);
+        }
+        ev.type = LeaveNotify;
+        stream.push_back(ev);
+    }
+}
+
+bool readStream(const char *filename, vector<Event> &stream,
+                vector<Window> &windows, vector<Window> &parents) {
+    ifstream file(filename);
+    if (!file)
+        return false;
+    map<Window, bool> seen;
+    Event ev;
+    while (file >> dec >> ev.type >> hex >> ev.win >> ev.parent) {
+        stream.push_back(ev);
+        if (!seen[ev.win]) {
+            seen[ev.win] = true;
+            windows.push_back(ev.win);
+        }
+    }
+    // unknown parents, so let every tenth window listen to its children
+    for (size_t i = 0; i < windows.size(); i += 10)
+        parents.push_back(windows[i]);
+    return !stream.empty();
+}
+
+// handler, then parent lookup, as EventManager::dispatch did with std::map
+uint64_t replayMap(const vector<Event> &stream, const vector<Window> &windows,
+                   const vector<Window> &parents, Handler &handler) {
+    map<Window, Handler *> handlers, parent_handlers;
+    for (size_t i = 0; i < windows.size(); ++i)
+        handlers[windows[i]] = &handler;
+    for (size_t i = 0; i < parents.size(); ++i)
+        parent_handlers[parents[i]] = &handler;
+
+    uint64_t start = FbTk::FbTime::mono();
+    for (size_t i = 0; i < stream.size(); ++i) {
+        map<Window, Handler *>::iterator it = handlers.find(stream[i].win);
+        if (it == handlers.end())
+            continue;
+        it->second->count++;
+        if (parent_handlers[stream[i].parent] != 0)
+            parent_handlers[stream[i].parent]->count++;
+    }
+    return FbTk::FbTime::mono() - start;
+}
+
+uint64_t replayTable(const vector<Event> &stream, const vector<Window> &windows,
+                     const vector<Window> &parents, Handler &handler) {
+    FbTk::WindowMap<Handler> handlers, parent_handlers;
+    for (size_t i = 0; i < windows.size(); ++i)
+        handlers.insert(windows[i], &handler);
+    for (size_t i = 0; i < parents.size(); ++i)
+        parent_handlers.insert(parents[i], &handler);
+
+    uint64_t start = FbTk::FbTime::mono();
+    for (size_t i = 0; i < stream.size(); ++i) {
+        Handler *evhand = handlers.find(stream[i].win);
+        if (evhand == 0)
+            continue;
+        evhand->count++;
+        Handler *parent = parent_handlers.find(stream[i].parent);
+        if (parent != 0)
+            parent->count++;
+    }
+    return FbTk::FbTime::mono() - start;
+}
+
+}
+
+int main(int argc, char **argv) {
+
+    srand(1);
+
+    check(testAgainstMap(), "lookups against std::map");
+
+    vector<Event> stream;
+    vector<Window> windows, parents;
+    if (argc > 1) {
+        if (!readStream(argv[1], stream, windows, parents)) {
+            cerr << "can't read events from " << argv[1] << endl;
+            return EXIT_FAILURE;
+        }
+    } else
+        generateStream(stream, windows, parents);
+
+    Handler map_handler, table_handler;
+    uint64_t map_usec = replayMap(stream, windows, parents, map_handler);
+    uint64_t table_usec = replayTable(stream, windows, parents, table_handler);
+    check(map_handler.count == table_handler.count, "replayed events dispatched");
+
+    cerr << "replay: " << stream.size() << " events, " << windows.size()
+         << " windows" << endl
+         << "  std::map:  " << map_usec << " usec ("
+         << map_usec * 1000 / stream.size() << " ns per event)" << endl
+         << "  WindowMap: " << table_usec << " usec ("
+         << table_usec * 1000 / stream.size() << " ns per event)" << endl;
+
+    return TestUtil::report("windowmap");
+}
@@ -25,6 +25,7 @@
 #include "EventHandler.hh"
 #include "EventManager.hh"
 #include "Timer.hh"
+#include "Reactor.hh"
 #include "SimpleCommand.hh"
 #include "stringstream.hh"
 #include "GContext.hh"
@@ -37,6 +38,12 @@
 #include <iostream>
 using namespace std;
 
+/// wakes up the reactor, the event loop reads the x events itself
+class XConnectionHandler: public FbTk::Reactor::Handler {
+public:
+    void handleFd(int) { }
+};
+
 class App:public FbTk::App, public FbTk::EventHandler {
 public:
     App(const char *displayname):
@@ -66,14 +73,17 @@ public:
     }
     void eventLoop() {
         XEvent ev;
+        XConnectionHandler x_connection;
+        FbTk::Reactor::add(ConnectionNumber(display()), x_connection);
         while (!done()) {
             if (XPending(display())) {
                 XNextEvent(display(), &ev);
                 FbTk::EventManager::instance()->handleEvent(ev);
             } else {
-                FbTk::Timer::updateTimers(ConnectionNumber(display()));
+                FbTk::Reactor::dispatch(true);
             }
         }
+        FbTk::Reactor::remove(ConnectionNumber(display()));
     }
 
     void updateTitle() {